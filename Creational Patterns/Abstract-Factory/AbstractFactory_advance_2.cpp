@@ -0,0 +1,393 @@
+/*
+* C++ Design Patterns: Abstract Factory
+*
+* Abstract factory pattern has creational purpose and provides an interface for
+* creating families of related or dependent objects without specifying their
+* concrete classes. Pattern applies to object and deal with object relationships,
+* which are more dynamic. In contrast to Factory Method, Abstract Factory pattern
+* produces family of types that are related, ie. it has more than one method of
+* types it produces.
+*
+* In this variant an army is created and destroyed as a whole. The factory places
+* the units in a memory arena owned by the Army, and destroying the Army releases
+* the arena at once instead of deleting every unit.
+*
+*/
+
+#include<iostream>
+#include<vector>
+#include<memory_resource>
+#include<chrono>
+#include<new>
+#include<cstddef>
+
+/*
+* ### When to use ###
+*
+* a system should be independent of how its products are created, composed, and represented
+* a system should be configured with one of multiple families of products
+* a family of related product objects is designed to be used together
+* you want to provide a class library of products, and you want to reveal just their interfaces, not their implementations
+*
+*/
+
+// Abstract base classes of all possible types of warriors
+#pragma region BaseUnits
+
+class Tank
+{
+public:
+	virtual void info()	= 0;
+	virtual ~Tank()		= default;
+	// ...
+};
+
+class Plain
+{
+public:
+	virtual void info()	= 0;
+	virtual ~Plain()	= default;
+	// ...
+};
+
+class Solder
+{
+public:
+	virtual void info()	= 0;
+	virtual ~Solder()	= default;
+	// ...
+};
+
+#pragma endregion
+
+// Classes of all types of warriors of the enemy team
+#pragma region EnemyUnits
+
+class EnemyTank : public Tank
+{
+public:
+	void info() override
+	{
+		std::cout << "Enemy Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int armor = 5;
+};
+
+class EnemyPlain : public Plain
+{
+public:
+	void info() override
+	{
+		std::cout << "Enemy Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int speed = 900;
+};
+
+class EnemySolder : public Solder
+{
+public:
+	void info() override
+	{
+		std::cout << "Enemy Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int ammo = 30;
+};
+
+#pragma endregion
+
+// Classes of all types of warriors of the friendly team
+#pragma region FriendlyUnits
+
+class FriendlyTank : public Tank
+{
+public:
+	void info() override
+	{
+		std::cout << "Friendly Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int armor = 7;
+};
+
+class FriendlyPlain : public Plain
+{
+public:
+	void info() override
+	{
+		std::cout << "Friendly Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int speed = 800;
+};
+
+class FriendlySolder : public Solder
+{
+public:
+	void info() override
+	{
+		std::cout << "Friendly Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int ammo = 40;
+};
+
+#pragma endregion
+
+// Abstract factory for the production of the army. A unit can be created
+// on the heap, to be deleted by its owner, or in an arena, to be released with it
+class ArmyFactory
+{
+public:
+	virtual Tank*	createTank()									= 0;
+	virtual Plain*	createPlain()									= 0;
+	virtual Solder* createSolder()									= 0;
+	virtual Tank*	createTank(std::pmr::memory_resource& arena)	= 0;
+	virtual Plain*	createPlain(std::pmr::memory_resource& arena)	= 0;
+	virtual Solder* createSolder(std::pmr::memory_resource& arena)	= 0;
+	virtual ~ArmyFactory()											= default;
+	// ...
+
+protected:
+	template<class T>
+	static T* construct(std::pmr::memory_resource& arena)
+	{
+		void* memory = arena.allocate(sizeof(T), alignof(T));
+		try
+		{
+			return ::new (memory) T();
+		}
+		catch (...)
+		{
+			arena.deallocate(memory, sizeof(T), alignof(T));
+			throw;
+		}
+	}
+};
+
+// Factory for the creation of the army of the enemy team
+class EnemyFactory : public ArmyFactory
+{
+public:
+	Tank * createTank() override
+	{
+		return new EnemyTank();
+	}
+	Plain* createPlain() override
+	{
+		return new EnemyPlain();
+	}
+	Solder* createSolder() override
+	{
+		return new EnemySolder();
+	}
+	Tank* createTank(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<EnemyTank>(arena);
+	}
+	Plain* createPlain(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<EnemyPlain>(arena);
+	}
+	Solder* createSolder(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<EnemySolder>(arena);
+	}
+	// ...
+};
+
+// Factory for the creation of the army of the friendly team
+class FriendlyFactory : public ArmyFactory
+{
+public:
+	Tank * createTank() override
+	{
+		return new FriendlyTank();
+	}
+	Plain* createPlain() override
+	{
+		return new FriendlyPlain();
+	}
+	Solder* createSolder() override
+	{
+		return new FriendlySolder();
+	}
+	Tank* createTank(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<FriendlyTank>(arena);
+	}
+	Plain* createPlain(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<FriendlyPlain>(arena);
+	}
+	Solder* createSolder(std::pmr::memory_resource& arena) override
+	{
+		return ArmyFactory::construct<FriendlySolder>(arena);
+	}
+	// ...
+};
+
+// Class containing the entire army of this or that team. The units and the lists
+// of them are placed in the arena of the army, and the destructors of the units
+// are not called: units made for an army must not own any resources themselves
+class Army
+{
+public:
+	Army() : tanks(&arena), plains(&arena), solders(&arena) {}
+	Army(const Army&)				= delete;
+	Army& operator = (const Army&)	= delete;
+	~Army()							= default;
+
+	void info()
+	{
+		for (auto object : tanks)	object->info();
+		for (auto object : plains)	object->info();
+		for (auto object : solders)	object->info();
+	}
+
+public:
+	// Declared first, so it outlives the lists placed in it
+	std::pmr::monotonic_buffer_resource arena;
+
+	std::pmr::vector<Tank*>		tanks;
+	std::pmr::vector<Plain*>	plains;
+	std::pmr::vector<Solder*>	solders;
+};
+
+// Here the army of this or that side is created
+class Game
+{
+public:
+	// An army of the given number of units, of all types in equal parts
+	Army * createArmy(ArmyFactory& factory, std::size_t units = 3)
+	{
+		Army* p = new Army();
+
+		std::size_t perType = units / 3;
+		p->tanks.reserve(perType);
+		p->plains.reserve(perType);
+		p->solders.reserve(units - 2 * perType);
+
+		for (std::size_t i = 0; i < perType; i++)
+		{
+			p->tanks.push_back(factory.createTank(p->arena));
+			p->plains.push_back(factory.createPlain(p->arena));
+		}
+		for (std::size_t i = 2 * perType; i < units; i++)
+			p->solders.push_back(factory.createSolder(p->arena));
+
+		return p;
+	}
+};
+
+#pragma region Benchmark
+
+// The army of AbstractFactory_advnce.cpp: every unit is on the heap and deleted one by one
+class HeapArmy
+{
+public:
+	~HeapArmy()
+	{
+		for (auto object : tanks)	delete object;
+		for (auto object : plains)	delete object;
+		for (auto object : solders)	delete object;
+	}
+
+public:
+	std::vector<Tank*>		tanks;
+	std::vector<Plain*>		plains;
+	std::vector<Solder*>	solders;
+};
+
+HeapArmy* createHeapArmy(ArmyFactory& factory, std::size_t units)
+{
+	HeapArmy* p = new HeapArmy();
+
+	std::size_t perType = units / 3;
+	p->tanks.reserve(perType);
+	p->plains.reserve(perType);
+	p->solders.reserve(units - 2 * perType);
+
+	for (std::size_t i = 0; i < perType; i++)
+	{
+		p->tanks.push_back(factory.createTank());
+		p->plains.push_back(factory.createPlain());
+	}
+	for (std::size_t i = 2 * perType; i < units; i++)
+		p->solders.push_back(factory.createSolder());
+
+	return p;
+}
+
+// Time of one create + destroy cycle, split into its two parts
+template<class Create>
+void measure(const char* name, Create create)
+{
+	const int cycles = 50;
+	std::chrono::duration<double, std::milli> creating{ 0 }, destroying{ 0 };
+
+	for (int i = 0; i < cycles; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto army = create();
+		auto middle = std::chrono::steady_clock::now();
+		delete army;
+		auto end = std::chrono::steady_clock::now();
+
+		creating += middle - start;
+		destroying += end - middle;
+	}
+
+	std::cout << name << "\t" << creating.count() / cycles << "\t" << destroying.count() / cycles << std::endl;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	Game			game;
+	EnemyFactory	eFactory;
+	FriendlyFactory fFactory;
+
+	Army* eArmy = game.createArmy(eFactory);
+	Army* fArmy = game.createArmy(fFactory);
+
+	std::cout << "Enemy army:" << std::endl;
+	eArmy->info();
+
+	std::cout << "\nFriendly army:" << std::endl;
+	fArmy->info();
+	// ...
+
+	delete eArmy;
+	delete fArmy;
+
+	const std::size_t units = 100000;
+	std::cout << std::endl << "Army of " << units << " units, ms:" << std::endl;
+	std::cout << "\tcreate\tdestroy" << std::endl;
+	measure("heap", [&eFactory]() { return createHeapArmy(eFactory, units); });
+	measure("arena", [&game, &eFactory]() { return game.createArmy(eFactory, units); });
+
+	return 0;
+}
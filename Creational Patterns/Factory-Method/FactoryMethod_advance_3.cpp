@@ -0,0 +1,307 @@
+/*
+ * C++ Design Patterns: Factory Method
+ *
+ * Define an interface for creating an object, but let subclasses decide which class to instantiate.
+ * Factory Method lets a class defer instantiation to subclasses. The pattern has creational purpose
+ * and applies to classes where deals with relationships through inheritence ie. they are static-fixed
+ * at compile time. In contrast to Abstract Factory, Factory Method contain method to produce only one
+ * type of product.
+ *
+ * In this variant the set of units is closed, and the factory returns a value instead of
+ * a pointer: Unit holds a std::variant of all unit types, made from one list of types.
+ * Units are stored inline in a vector, without a heap allocation or a vtable pointer
+ * per unit, and a call is dispatched by the index of the variant instead of a virtual call.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<variant>
+#include<chrono>
+#include<random>
+#include<stdexcept>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * a class cant anticipate the class of objects it must create
+ * a class wants its subclasses to specify the objects it creates
+ * classes delegate responsibility to one of several helper subclasses, and you want to localize the knowledge of which helper subclass is the delegate
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+// List of types, only used at compile time
+template<class... Types>
+struct TypeList {};
+
+// Game characters are plain classes without a common base
+#pragma region Units
+
+class Tank
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Tank_ID;
+
+	void info() const
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	int power() const
+	{
+		return health * armor;
+	}
+	// ...
+
+private:
+	int health = 100;
+	int armor = 5;
+};
+
+class Plain
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Plain_ID;
+
+	void info() const
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	int power() const
+	{
+		return health + speed;
+	}
+	// ...
+
+private:
+	int health = 100;
+	int speed = 900;
+};
+
+class Solder
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Solder_ID;
+
+	void info() const
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	int power() const
+	{
+		return health;
+	}
+	// ...
+
+private:
+	int health = 100;
+};
+
+#pragma endregion
+
+// All unit types. A new unit type is added here and to Entity_ID
+typedef TypeList<Tank, Plain, Solder> UnitTypes;
+
+template<class List>
+struct VariantOf;
+
+template<class... Types>
+struct VariantOf<TypeList<Types...>>
+{
+	typedef std::variant<Types...> type;
+};
+
+// Every identifier has exactly one unit type
+template<class... Types>
+constexpr bool coversAllIds(TypeList<Types...>)
+{
+	std::size_t count[std::size_t(Entity_ID::Count)] = {};
+	((count[std::size_t(Types::id)]++), ...);
+	for (std::size_t n : count)
+		if (n != 1)
+			return false;
+	return true;
+}
+
+static_assert(coversAllIds(UnitTypes{}), "every Entity_ID needs exactly one unit type");
+
+// A unit of any type, held by value
+class Unit
+{
+public:
+	typedef VariantOf<UnitTypes>::type Value;
+
+	static Unit createEntity(Entity_ID id);
+
+	void info() const
+	{
+		std::visit([](const auto& unit) { unit.info(); }, value);
+	}
+	int power() const
+	{
+		return std::visit([](const auto& unit) { return unit.power(); }, value);
+	}
+	// ...
+
+private:
+	template<class... Types>
+	static Value make(Entity_ID id, TypeList<Types...>);
+
+	Value value;
+};
+
+#pragma region Benchmark
+
+// The pointer-based path of FactoryMethod_advance_1.cpp over the same units:
+// one heap object with a vtable per unit
+class HeapUnit
+{
+public:
+	virtual int power() const	= 0;
+	virtual ~HeapUnit()			= default;
+};
+
+template<class T>
+class HeapUnitOf final : public HeapUnit
+{
+public:
+	int power() const override
+	{
+		return unit.power();
+	}
+
+private:
+	T unit;
+};
+
+HeapUnit* createHeapEntity(Entity_ID id)
+{
+	switch (id)
+	{
+	case Entity_ID::Tank_ID:	return new HeapUnitOf<Tank>();		break;
+	case Entity_ID::Plain_ID:	return new HeapUnitOf<Plain>();		break;
+	case Entity_ID::Solder_ID:	return new HeapUnitOf<Solder>();	break;
+	default:					break;
+	}
+	return nullptr;
+}
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+#pragma endregion
+
+
+// Creating objects using object factories
+int main()
+{
+	std::vector<Unit> vec;
+	vec.push_back(Unit::createEntity(Entity_ID::Tank_ID));
+	vec.push_back(Unit::createEntity(Entity_ID::Plain_ID));
+	vec.push_back(Unit::createEntity(Entity_ID::Solder_ID));
+
+	for (auto& object : vec)
+		object.info();
+	// ...
+
+	// A mixed population in random order
+	const std::size_t n = 10000000;
+	const int passes = 5;
+	std::vector<Entity_ID> ids(n);
+	std::mt19937 random(7);
+	for (auto& id : ids)
+		id = Entity_ID(random() % std::size_t(Entity_ID::Count));
+
+	std::cout << std::endl << n << " units, ms:" << std::endl;
+	std::cout << "\t\tcreate\titerate\tdestroy\tbytes/unit" << std::endl;
+
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::vector<HeapUnit*> units;
+		units.reserve(n);
+		for (auto id : ids)
+			units.push_back(createHeapEntity(id));
+		double create = elapsedMilliseconds(start);
+
+		start = std::chrono::steady_clock::now();
+		long long sum = 0;
+		for (int pass = 0; pass < passes; pass++)
+			for (auto object : units)
+				sum += object->power();
+		double iterate = elapsedMilliseconds(start) / passes;
+		sink = sum;
+
+		start = std::chrono::steady_clock::now();
+		for (auto object : units)
+			delete object;
+		units.clear();
+		units.shrink_to_fit();
+		double destroy = elapsedMilliseconds(start);
+
+		std::cout << "pointers\t" << create << "\t" << iterate << "\t" << destroy << "\t"
+			<< sizeof(HeapUnit*) << " + heap object" << std::endl;
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::vector<Unit> units;
+		units.reserve(n);
+		for (auto id : ids)
+			units.push_back(Unit::createEntity(id));
+		double create = elapsedMilliseconds(start);
+
+		start = std::chrono::steady_clock::now();
+		long long sum = 0;
+		for (int pass = 0; pass < passes; pass++)
+			for (auto& object : units)
+				sum += object.power();
+		double iterate = elapsedMilliseconds(start) / passes;
+		sink = sum;
+
+		start = std::chrono::steady_clock::now();
+		units.clear();
+		units.shrink_to_fit();
+		double destroy = elapsedMilliseconds(start);
+
+		std::cout << "variant\t\t" << create << "\t" << iterate << "\t" << destroy << "\t"
+			<< sizeof(Unit) << std::endl;
+	}
+
+	return 0;
+}
+
+Unit Unit::createEntity(Entity_ID id)
+{
+	Unit unit;
+	unit.value = make(id, UnitTypes{});
+	return unit;
+}
+
+// Checks the identifier of every type in the list; the compiler turns it into a switch
+template<class... Types>
+Unit::Value Unit::make(Entity_ID id, TypeList<Types...>)
+{
+	Value value;
+	bool found = ((id == Types::id ? (value.template emplace<Types>(), true) : false) || ...);
+	if (!found)
+		throw std::invalid_argument("Unit::createEntity: unknown Entity_ID");
+	return value;
+}
@@ -0,0 +1,363 @@
+/*
+ * C++ Design Patterns: Factory Method
+ *
+ * Define an interface for creating an object, but let subclasses decide which class to instantiate.
+ * Factory Method lets a class defer instantiation to subclasses. The pattern has creational purpose
+ * and applies to classes where deals with relationships through inheritence ie. they are static-fixed
+ * at compile time. In contrast to Abstract Factory, Factory Method contain method to produce only one
+ * type of product.
+ *
+ * In this variant the factory creates units straight into a storage with one array per
+ * concrete type. A loop over the storage walks each array with a statically known type,
+ * so the calls are direct and the branches predictable, instead of an indirect call
+ * through the vtable of every unit in a vector of mixed Unit pointers.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<tuple>
+#include<string>
+#include<chrono>
+#include<random>
+#include<stdexcept>
+#include<cstddef>
+#include<cstdint>
+#ifdef __linux__
+#include<cstring>
+#include<linux/perf_event.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+/*
+ * ### When to use ###
+ *
+ * a class cant anticipate the class of objects it must create
+ * a class wants its subclasses to specify the objects it creates
+ * classes delegate responsibility to one of several helper subclasses, and you want to localize the knowledge of which helper subclass is the delegate
+ *
+ */
+
+// Identifiers of all units
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID
+};
+
+// Hierarchy of classes of game characters
+#pragma region Units
+
+class Unit
+{
+public:
+	virtual void info()		= 0;
+	virtual int power()		= 0;
+	virtual ~Unit()			= default;
+
+	static Unit* createEntity(Entity_ID id);
+	// ...
+
+protected:
+	int health = 100;
+};
+
+class Tank final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Tank_ID;
+
+	void info() override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health * armor;
+	}
+	// ...
+
+private:
+	int armor = 5;
+};
+
+class Plain final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Plain_ID;
+
+	void info() override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health + speed;
+	}
+	// ...
+
+private:
+	int speed = 900;
+};
+
+class Solder final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Solder_ID;
+
+	void info() override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health;
+	}
+	// ...
+};
+
+#pragma endregion
+
+// Units of the listed types, each type in its own contiguous array.
+// References to units stay valid only until the next createEntity()
+template<class... Types>
+class UnitStorage
+{
+public:
+	Unit& createEntity(Entity_ID id)
+	{
+		Unit* unit = nullptr;
+		((id == Types::id ? (unit = &bucket<Types>().emplace_back(), true) : false) || ...);
+		if (unit == nullptr)
+			throw std::invalid_argument("UnitStorage::createEntity: unknown Entity_ID");
+		return *unit;
+	}
+
+	// Calls function for every unit, passing it as its concrete type
+	template<class Function>
+	void forEach(Function function)
+	{
+		(forEachIn(bucket<Types>(), function), ...);
+	}
+
+	template<class T>
+	std::vector<T>& bucket()
+	{
+		return std::get<std::vector<T>>(buckets);
+	}
+
+	std::size_t size() const
+	{
+		return (std::get<std::vector<Types>>(buckets).size() + ...);
+	}
+	void reserve(std::size_t perType)
+	{
+		(bucket<Types>().reserve(perType), ...);
+	}
+
+private:
+	template<class T, class Function>
+	static void forEachIn(std::vector<T>& units, Function& function)
+	{
+		for (auto& unit : units)
+			function(unit);
+	}
+
+	std::tuple<std::vector<Types>...> buckets;
+};
+
+typedef UnitStorage<Tank, Plain, Solder> Units;
+
+#pragma region Benchmark
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+// Hardware counters of the calling thread in user mode, enabled only around
+// the measured loop. Linux only (perf_event_open); they are unavailable elsewhere,
+// in virtual machines without a PMU and when perf_event_paranoid forbids them
+class PerfCounters
+{
+public:
+	enum Event { Instructions = 0, BranchMisses, Events };
+
+	PerfCounters()
+	{
+		for (int e = 0; e < Events; e++)
+			fds[e] = open(Event(e));
+	}
+	~PerfCounters()
+	{
+		for (int fd : fds)
+			close(fd);
+	}
+	PerfCounters(const PerfCounters&)				= delete;
+	PerfCounters& operator = (const PerfCounters&)	= delete;
+
+	bool available() const
+	{
+		return fds[Instructions] != -1 && fds[BranchMisses] != -1;
+	}
+	void start()
+	{
+		for (int fd : fds)
+			control(fd, true);
+	}
+	void stop()
+	{
+		for (int fd : fds)
+			control(fd, false);
+	}
+	long long value(Event e) const
+	{
+		return read(fds[e]);
+	}
+
+private:
+#ifdef __linux__
+	static int open(Event e)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = e == Instructions ? PERF_COUNT_HW_INSTRUCTIONS : PERF_COUNT_HW_BRANCH_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+	static void close(int fd)
+	{
+		if (fd != -1)
+			::close(fd);
+	}
+	static void control(int fd, bool enable)
+	{
+		if (enable)
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+	}
+	static long long read(int fd)
+	{
+		std::uint64_t count = 0;
+		if (::read(fd, &count, sizeof(count)) != sizeof(count))
+			return -1;
+		return (long long)count;
+	}
+#else
+	static int open(Event)				{ return -1; }
+	static void close(int)				{}
+	static void control(int, bool)		{}
+	static long long read(int)			{ return -1; }
+#endif
+
+	int fds[Events];
+};
+
+// Time, instructions and branch misses per unit of one pass over the population
+template<class Pass>
+void measure(const char* name, std::size_t units, Pass pass)
+{
+	const int passes = 20;
+	const double visited = double(units) * passes;
+	PerfCounters counters;
+
+	auto start = std::chrono::steady_clock::now();
+	counters.start();
+	long long sum = 0;
+	for (int i = 0; i < passes; i++)
+		sum += pass();
+	counters.stop();
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	sink = sum;
+
+	std::cout << name << "\t" << elapsed.count() / visited << " ns/unit\t";
+	if (counters.available())
+		std::cout << counters.value(PerfCounters::Instructions) / visited << " instructions/unit\t"
+			<< counters.value(PerfCounters::BranchMisses) / visited << " branch misses/unit" << std::endl;
+	else
+		std::cout << "hardware counters unavailable" << std::endl;
+}
+
+#pragma endregion
+
+
+// Creating objects using object factories
+int main(int argc, char* argv[])
+{
+	Units storage;
+	storage.createEntity(Entity_ID::Tank_ID);
+	storage.createEntity(Entity_ID::Plain_ID);
+	storage.createEntity(Entity_ID::Solder_ID);
+
+	storage.forEach([](auto& object) { object.info(); });
+	// ...
+
+	// "interleaved" or "buckets" builds and measures only that layout
+	std::string layout = argc > 1 ? argv[1] : "";
+	bool useInterleaved = layout.empty() || layout == "interleaved";
+	bool useBuckets = layout.empty() || layout == "buckets";
+
+	// The same mixed population in random order in both layouts
+	const std::size_t n = 1000000;
+	std::mt19937 random(7);
+	std::vector<Unit*> interleaved;
+	Units buckets;
+	if (useInterleaved)
+		interleaved.reserve(n);
+	if (useBuckets)
+		buckets.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+	{
+		Entity_ID id = Entity_ID(random() % 3);
+		if (useInterleaved)
+			interleaved.push_back(Unit::createEntity(id));
+		if (useBuckets)
+			buckets.createEntity(id);
+	}
+
+	std::cout << std::endl << n << " units:" << std::endl;
+
+	if (useInterleaved)
+	{
+		measure("interleaved", n, [&interleaved]()
+		{
+			long long sum = 0;
+			for (auto object : interleaved)
+				sum += object->power();
+			return sum;
+		});
+	}
+	if (useBuckets)
+	{
+		measure("buckets", buckets.size(), [&buckets]()
+		{
+			long long sum = 0;
+			buckets.forEach([&sum](auto& object) { sum += object.power(); });
+			return sum;
+		});
+	}
+
+	for (auto object : interleaved)
+		delete object;
+
+	return 0;
+}
+
+Unit * Unit::createEntity(Entity_ID id)
+{
+	switch (id)
+	{
+	case Entity_ID::Tank_ID:	return new Tank();		break;
+	case Entity_ID::Plain_ID:	return new Plain();		break;
+	case Entity_ID::Solder_ID:	return new Solder();	break;
+	}
+	return nullptr;
+}
@@ -0,0 +1,293 @@
+/*
+ * C++ Design Patterns: Factory Method
+ *
+ * Define an interface for creating an object, but let subclasses decide which class to instantiate.
+ * Factory Method lets a class defer instantiation to subclasses. The pattern has creational purpose
+ * and applies to classes where deals with relationships through inheritence ie. they are static-fixed
+ * at compile time. In contrast to Abstract Factory, Factory Method contain method to produce only one
+ * type of product.
+ *
+ * In this variant a factory can create a whole wave of units in one call. createBatch()
+ * places N units in a single block of memory and writes their addresses to storage given
+ * by the caller: one virtual call and one allocation instead of N of each.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<chrono>
+#include<new>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * a class cant anticipate the class of objects it must create
+ * a class wants its subclasses to specify the objects it creates
+ * classes delegate responsibility to one of several helper subclasses, and you want to localize the knowledge of which helper subclass is the delegate
+ *
+ */
+
+// Hierarchy of classes of game characters
+#pragma region Units
+
+class Unit
+{
+public:
+	virtual void info()	= 0;
+	virtual ~Unit()		= default;
+	// ...
+};
+
+class Tank : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int armor = 5;
+};
+
+class Plain : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int speed = 900;
+};
+
+class Solder : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int ammo = 30;
+};
+
+#pragma endregion
+
+// Owner of the units created by one createBatch() call: destroys them
+// and frees their block. The units must not be deleted one by one
+class UnitBatch
+{
+public:
+	typedef void (*Destroyer)(void* block, std::size_t count);
+
+	UnitBatch() : block(nullptr), count(0), destroy(nullptr) {}
+	UnitBatch(void* block, std::size_t count, Destroyer destroy) : block(block), count(count), destroy(destroy) {}
+	UnitBatch(UnitBatch&& other) noexcept : block(other.block), count(other.count), destroy(other.destroy)
+	{
+		other.block = nullptr;
+	}
+	// Destroys the units held now before taking over the other batch
+	UnitBatch& operator = (UnitBatch&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (block != nullptr)
+				destroy(block, count);
+			block = other.block;
+			count = other.count;
+			destroy = other.destroy;
+			other.block = nullptr;
+		}
+		return *this;
+	}
+	UnitBatch(const UnitBatch&)					= delete;
+	UnitBatch& operator = (const UnitBatch&)	= delete;
+	~UnitBatch()
+	{
+		if (block != nullptr)
+			destroy(block, count);
+	}
+
+	std::size_t size() const
+	{
+		return count;
+	}
+
+private:
+	void* block;
+	std::size_t count;
+	Destroyer destroy;
+};
+
+// Factories of objects
+#pragma region Factories
+
+class Factory
+{
+public:
+	virtual Unit* create()									= 0;
+	// Creates n units and writes their addresses to out[0], ..., out[n - 1]
+	virtual UnitBatch createBatch(std::size_t n, Unit** out)	= 0;
+	virtual ~Factory()										= default;
+	// ...
+
+protected:
+	// Constructs n units of type T back to back in one block
+	template<class T>
+	static UnitBatch createBlock(std::size_t n, Unit** out)
+	{
+		if (n == 0)
+			return UnitBatch();
+
+		T* units = static_cast<T*>(::operator new(n * sizeof(T)));
+		std::size_t built = 0;
+		try
+		{
+			for (; built < n; built++)
+				out[built] = ::new (static_cast<void*>(units + built)) T();
+		}
+		catch (...)
+		{
+			destroyBlock<T>(units, built);
+			throw;
+		}
+
+		return UnitBatch(units, n, &destroyBlock<T>);
+	}
+
+private:
+	template<class T>
+	static void destroyBlock(void* block, std::size_t count)
+	{
+		T* units = static_cast<T*>(block);
+		for (std::size_t i = 0; i < count; i++)
+			units[i].~T();
+		::operator delete(block);
+	}
+};
+
+class TankFactory : public Factory
+{
+public:
+	Unit * create() override
+	{
+		return new Tank();
+	}
+	UnitBatch createBatch(std::size_t n, Unit** out) override
+	{
+		return Factory::createBlock<Tank>(n, out);
+	}
+	// ...
+};
+
+class PlainFactory : public Factory
+{
+public:
+	Unit * create() override
+	{
+		return new Plain();
+	}
+	UnitBatch createBatch(std::size_t n, Unit** out) override
+	{
+		return Factory::createBlock<Plain>(n, out);
+	}
+	// ...
+};
+
+class SolderFactory : public Factory
+{
+public:
+	Unit * create() override
+	{
+		return new Solder();
+	}
+	UnitBatch createBatch(std::size_t n, Unit** out) override
+	{
+		return Factory::createBlock<Solder>(n, out);
+	}
+	// ...
+};
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// Time per unit to spawn and despawn waves of the given size, taking the factory
+// for each wave in turn; the wave is written to the same vector in both cases
+void measure(std::vector<Factory*>& factories, std::size_t wave)
+{
+	const std::size_t total = 3000000;
+	const std::size_t waves = total / wave;
+	std::vector<Unit*> units(wave);
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t w = 0; w < waves; w++)
+	{
+		Factory* factory = factories[w % factories.size()];
+		for (std::size_t i = 0; i < wave; i++)
+			units[i] = factory->create();
+		for (auto object : units)
+			delete object;
+	}
+	std::chrono::duration<double, std::nano> single = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	for (std::size_t w = 0; w < waves; w++)
+	{
+		Factory* factory = factories[w % factories.size()];
+		UnitBatch batch = factory->createBatch(wave, units.data());
+	}
+	std::chrono::duration<double, std::nano> batched = std::chrono::steady_clock::now() - start;
+
+	std::size_t spawned = waves * wave;
+	std::cout << wave << "\t" << single.count() / spawned << "\t\t" << batched.count() / spawned << std::endl;
+}
+
+#pragma endregion
+
+
+// Creating objects using object factories
+int main()
+{
+	std::vector<Factory*> factories{
+		new TankFactory(),
+		new PlainFactory(),
+		new SolderFactory()
+		// ...
+	};
+
+	// A wave of two units of every type, appended to the same vector
+	std::vector<Unit*> vec;
+	std::vector<UnitBatch> batches;
+
+	for (auto& factor : factories)
+	{
+		std::size_t first = vec.size();
+		vec.resize(first + 2);
+		batches.push_back(factor->createBatch(2, vec.data() + first));
+	}
+
+	for (auto& object : vec)
+		object->info();
+	// ...
+
+	std::cout << std::endl << "spawn + despawn, ns/unit:" << std::endl;
+	std::cout << "wave\tcreate()\tcreateBatch()" << std::endl;
+	for (std::size_t wave : { 1, 16, 256, 4096 })
+		measure(factories, wave);
+
+	for (auto& factor : factories)
+		delete factor;
+
+	return 0;
+}
@@ -0,0 +1,380 @@
+/*
+ * C++ Design Patterns: Factory Method
+ *
+ * Define an interface for creating an object, but let subclasses decide which class to instantiate.
+ * Factory Method lets a class defer instantiation to subclasses. The pattern has creational purpose
+ * and applies to classes where deals with relationships through inheritence ie. they are static-fixed
+ * at compile time. In contrast to Abstract Factory, Factory Method contain method to produce only one
+ * type of product.
+ *
+ * In this variant units are created by the name of their type, as read from data files.
+ * Every unit type registers its creator under its name. After startup the registry is
+ * frozen into a minimal perfect hash, so finding the creator for a name takes one pass
+ * of the hash function over the name and one comparison, without building a std::string.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<string>
+#include<string_view>
+#include<map>
+#include<algorithm>
+#include<charconv>
+#include<system_error>
+#include<chrono>
+#include<random>
+#include<stdexcept>
+#include<cstdint>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * a class cant anticipate the class of objects it must create
+ * a class wants its subclasses to specify the objects it creates
+ * classes delegate responsibility to one of several helper subclasses, and you want to localize the knowledge of which helper subclass is the delegate
+ *
+ */
+
+// Identifiers of all units, used by the old path in the benchmark
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID
+};
+
+class Unit
+{
+public:
+	virtual void info()		= 0;
+	virtual ~Unit()			= default;
+
+	static Unit* createEntity(Entity_ID id);
+
+	void place(int x, int y)
+	{
+		this->x = x;
+		this->y = y;
+	}
+	// ...
+
+protected:
+	int x = 0;
+	int y = 0;
+};
+
+// Creators of units by the name of their type. Names are added before main() and
+// the registry is frozen once at startup; after that it is only read
+class UnitRegistry
+{
+public:
+	typedef Unit* (*Creator)();
+
+	static UnitRegistry& getInstance()
+	{
+		static UnitRegistry instance;
+		return instance;
+	}
+
+	void add(std::string_view name, Creator creator)
+	{
+		if (frozen)
+			throw std::logic_error("UnitRegistry: registration after freeze()");
+		for (auto& entry : table)
+			if (entry.name == name)
+				throw std::logic_error("UnitRegistry: type registered twice");
+
+		table.push_back(Entry{ std::string(name), creator });
+	}
+
+	// Builds the hash. Keys are spread over buckets by their hash; then, starting from
+	// the largest bucket, every bucket gets a seed which sends all of its keys to free
+	// slots of the table. The table has exactly one slot per name
+	void freeze()
+	{
+		const std::size_t n = table.size();
+		std::vector<std::vector<std::size_t>> buckets(std::max<std::size_t>(n / 2, 1));
+		for (std::size_t i = 0; i < n; i++)
+			buckets[hash(table[i].name) % buckets.size()].push_back(i);
+
+		std::vector<std::size_t> order(buckets.size());
+		for (std::size_t b = 0; b < order.size(); b++)
+			order[b] = b;
+		std::sort(order.begin(), order.end(),
+			[&buckets](std::size_t a, std::size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+		seeds.assign(buckets.size(), 0);
+		std::vector<Entry> slots(n);
+		std::vector<bool> taken(n, false);
+		std::vector<std::size_t> placed;
+
+		for (std::size_t b : order)
+		{
+			if (buckets[b].empty())
+				break;
+
+			std::uint32_t seed = 0;
+			for (;; seed++)
+			{
+				if (seed == maxSeed)
+					throw std::logic_error("UnitRegistry: no perfect hash, two names hash the same");
+
+				placed.clear();
+				for (std::size_t key : buckets[b])
+				{
+					std::size_t slot = slotOf(hash(table[key].name), seed);
+					if (taken[slot] || std::find(placed.begin(), placed.end(), slot) != placed.end())
+						break;
+					placed.push_back(slot);
+				}
+				if (placed.size() == buckets[b].size())
+					break;
+			}
+
+			seeds[b] = seed;
+			for (std::size_t k = 0; k < placed.size(); k++)
+			{
+				taken[placed[k]] = true;
+				slots[placed[k]] = std::move(table[buckets[b][k]]);
+			}
+		}
+
+		table = std::move(slots);
+		frozen = true;
+	}
+
+	// nullptr for an unknown name
+	Unit* create(std::string_view name) const
+	{
+		if (!frozen)
+			throw std::logic_error("UnitRegistry: create() before freeze()");
+		if (table.empty())
+			return nullptr;
+
+		std::uint64_t h = hash(name);
+		const Entry& entry = table[slotOf(h, seeds[h % seeds.size()])];
+
+		return entry.name == name ? entry.creator() : nullptr;
+	}
+
+protected:
+	UnitRegistry() : frozen(false) {}
+	UnitRegistry(const UnitRegistry&)				= delete;
+	UnitRegistry& operator = (UnitRegistry&)		= delete;
+
+private:
+	static const std::uint32_t maxSeed = 1u << 20;
+
+	struct Entry
+	{
+		std::string name;
+		Creator creator = nullptr;
+	};
+
+	// FNV-1a
+	static std::uint64_t hash(std::string_view name)
+	{
+		std::uint64_t h = 14695981039346656037ull;
+		for (char c : name)
+		{
+			h ^= static_cast<unsigned char>(c);
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+	// Mixes the seed into the hash without hashing the name again
+	std::size_t slotOf(std::uint64_t h, std::uint32_t seed) const
+	{
+		h += seed * 0x9E3779B97F4A7C15ull;
+		h ^= h >> 30;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 27;
+		h *= 0x94D049BB133111EBull;
+		h ^= h >> 31;
+		return std::size_t(h % table.size());
+	}
+
+	std::vector<Entry> table;
+	std::vector<std::uint32_t> seeds;
+	bool frozen;
+};
+
+// Registers the creator of T under the given name
+template<class T>
+class Registrar
+{
+public:
+	explicit Registrar(std::string_view name)
+	{
+		UnitRegistry::getInstance().add(name, []() -> Unit* { return new T(); });
+	}
+};
+
+// Hierarchy of classes of game characters; each of them registers itself
+#pragma region Units
+
+class Tank : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Tank at " << x << ", " << y << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Registrar<Tank> registrar;
+};
+
+class Plain : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Plain at " << x << ", " << y << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Registrar<Plain> registrar;
+};
+
+class Solder : public Unit
+{
+public:
+	void info() override
+	{
+		std::cout << "Solder at " << x << ", " << y << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Registrar<Solder> registrar;
+};
+
+Registrar<Tank>		Tank::registrar("Tank");
+Registrar<Plain>	Plain::registrar("Plain");
+Registrar<Solder>	Solder::registrar("Solder");
+
+#pragma endregion
+
+// Spawns a unit from a record "<type> <x> <y>"; nullptr if the record is wrong
+template<class Create>
+Unit* spawn(std::string_view record, Create create)
+{
+	std::size_t space = record.find(' ');
+	if (space == std::string_view::npos)
+		return nullptr;
+
+	// The position is parsed first, so a wrong record creates nothing
+	const char* end = record.data() + record.size();
+	int x = 0, y = 0;
+	auto parsed = std::from_chars(record.data() + space + 1, end, x);
+	if (parsed.ec != std::errc() || parsed.ptr == end || *parsed.ptr != ' ')
+		return nullptr;
+	parsed = std::from_chars(parsed.ptr + 1, end, y);
+	if (parsed.ec != std::errc() || parsed.ptr != end)
+		return nullptr;
+
+	Unit* unit = create(record.substr(0, space));
+	if (unit != nullptr)
+		unit->place(x, y);
+
+	return unit;
+}
+
+#pragma region Benchmark
+
+// The old path: the name is looked up in a map of std::string, then createEntity() switches
+Unit* createFromMap(std::string_view name)
+{
+	static const std::map<std::string, Entity_ID> ids{
+		{ "Tank", Entity_ID::Tank_ID },
+		{ "Plain", Entity_ID::Plain_ID },
+		{ "Solder", Entity_ID::Solder_ID }
+	};
+
+	auto found = ids.find(std::string(name));
+	return found != ids.end() ? Unit::createEntity(found->second) : nullptr;
+}
+
+// Parses all records of a spawn file and destroys the spawned units
+template<class Create>
+void measure(const char* name, const std::string& file, Create create)
+{
+	auto start = std::chrono::steady_clock::now();
+	std::size_t spawned = 0;
+	std::string_view rest = file;
+	while (!rest.empty())
+	{
+		std::size_t eol = rest.find('\n');
+		Unit* unit = spawn(rest.substr(0, eol), create);
+		if (unit != nullptr)
+			spawned++;
+		delete unit;
+		rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << name << "\t" << elapsed.count() << " ms\t" << spawned << " units" << std::endl;
+}
+
+#pragma endregion
+
+
+// Creating objects using object factories
+int main()
+{
+	UnitRegistry& registry = UnitRegistry::getInstance();
+	registry.freeze();
+
+	std::vector<Unit*> vec;
+	for (std::string_view record : { "Tank 10 20", "Plain 0 300", "Solder 5 5", "Dragon 1 1" })
+	{
+		Unit* unit = spawn(record, [&registry](std::string_view name) { return registry.create(name); });
+		if (unit != nullptr)
+			vec.push_back(unit);
+		else
+			std::cout << "Unknown record: " << record << std::endl;
+	}
+
+	for (auto& object : vec)
+		object->info();
+	// ...
+
+	for (auto& object : vec)
+		delete object;
+
+	// A million spawn records of random types and positions
+	const std::size_t records = 1000000;
+	const char* names[] = { "Tank", "Plain", "Solder" };
+	std::mt19937 random(7);
+	std::string file;
+	for (std::size_t i = 0; i < records; i++)
+	{
+		file += names[random() % 3];
+		file += ' ' + std::to_string(random() % 1000) + ' ' + std::to_string(random() % 1000) + '\n';
+	}
+
+	std::cout << std::endl << records << " spawn records:" << std::endl;
+	measure("std::map", file, createFromMap);
+	measure("perfect hash", file, [&registry](std::string_view name) { return registry.create(name); });
+
+	return 0;
+}
+
+Unit * Unit::createEntity(Entity_ID id)
+{
+	switch (id)
+	{
+	case Entity_ID::Tank_ID:	return new Tank();		break;
+	case Entity_ID::Plain_ID:	return new Plain();		break;
+	case Entity_ID::Solder_ID:	return new Solder();	break;
+	}
+	return nullptr;
+}
@@ -0,0 +1,390 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant can be shared between threads. Each thread keeps a small local cache
+ * ("magazine") of free objects, and whole magazines are exchanged with a shared
+ * lock-free depot, so most acquire/release calls never touch shared memory.
+ *
+ */
+
+#include<iostream>
+#include<list>
+#include<mutex>
+#include<atomic>
+#include<thread>
+#include<vector>
+#include<chrono>
+#include<memory>
+#include<algorithm>
+#include<cstdint>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * A thread-caching pool is used when many threads acquire and release objects at a high
+ * rate, and a single lock around the pool would make them wait for each other.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Fixed-size stack of free objects. A magazine is owned either by
+// one thread or by the depot, never by both at the same time
+struct Magazine
+{
+	static const std::size_t capacity = 32;
+
+	std::size_t				count = 0;
+	Resource*				objects[capacity];
+	std::atomic<uint32_t>	next{ 0 };
+};
+
+// Lock-free stack of magazines (Treiber stack). Magazines are addressed by
+// index, and the head carries a version tag next to the index to rule out ABA
+class MagazineStack
+{
+public:
+	explicit MagazineStack(Magazine* storage) : magazines(storage), head(0) {}
+
+	void push(uint32_t index)
+	{
+		uint64_t old = head.load(std::memory_order_relaxed);
+		uint64_t desired;
+		do
+		{
+			magazines[index].next.store(link(old), std::memory_order_relaxed);
+			desired = pack(tag(old) + 1, index + 1);
+		} while (!head.compare_exchange_weak(old, desired,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+	bool pop(uint32_t& index)
+	{
+		uint64_t old = head.load(std::memory_order_acquire);
+		uint64_t desired;
+		do
+		{
+			if (link(old) == 0)
+				return false;
+			uint32_t next = magazines[link(old) - 1].next.load(std::memory_order_relaxed);
+			desired = pack(tag(old) + 1, next);
+		} while (!head.compare_exchange_weak(old, desired,
+			std::memory_order_acquire, std::memory_order_acquire));
+
+		index = link(old) - 1;
+		return true;
+	}
+
+private:
+	// The lower half holds index + 1 (0 is the end of the stack),
+	// the upper half holds the version tag
+	static uint64_t pack(uint32_t tag, uint32_t link)	{ return (uint64_t(tag) << 32) | link; }
+	static uint32_t tag(uint64_t value)					{ return uint32_t(value >> 32); }
+	static uint32_t link(uint64_t value)				{ return uint32_t(value); }
+
+	Magazine* magazines;
+	alignas(64) std::atomic<uint64_t> head;
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		// Initialization of a local static is thread-safe since C++11
+		static ObjectPool instance;
+		return instance;
+	}
+	Resource* getResource()
+	{
+		ThreadCache& cache = localCache();
+		if (cache.loaded == ThreadCache::none)
+			return new Resource();
+
+		Magazine* loaded = &magazines[cache.loaded];
+		if (loaded->count == 0)
+		{
+			if (magazines[cache.previous].count > 0)
+			{
+				std::swap(cache.loaded, cache.previous);
+			}
+			else
+			{
+				uint32_t full;
+				if (!fullMagazines.pop(full))
+					return new Resource();
+
+				emptyMagazines.push(cache.previous);
+				cache.previous = cache.loaded;
+				cache.loaded = full;
+			}
+			loaded = &magazines[cache.loaded];
+		}
+
+		return loaded->objects[--loaded->count];
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		ThreadCache& cache = localCache();
+		if (cache.loaded == ThreadCache::none)
+		{
+			delete object;
+			return;
+		}
+
+		Magazine* loaded = &magazines[cache.loaded];
+		if (loaded->count == Magazine::capacity)
+		{
+			if (magazines[cache.previous].count == 0)
+			{
+				std::swap(cache.loaded, cache.previous);
+			}
+			else
+			{
+				uint32_t empty;
+				if (!emptyMagazines.pop(empty))
+				{
+					// The pool already caches as many objects as it is allowed to
+					delete object;
+					return;
+				}
+
+				fullMagazines.push(cache.previous);
+				cache.previous = cache.loaded;
+				cache.loaded = empty;
+			}
+			loaded = &magazines[cache.loaded];
+		}
+
+		loaded->objects[loaded->count++] = object;
+	}
+
+protected:
+	ObjectPool()
+		: magazines(new Magazine[magazineCount]),
+		fullMagazines(magazines.get()),
+		emptyMagazines(magazines.get())
+	{
+		for (uint32_t i = 0; i < magazineCount; i++)
+			emptyMagazines.push(i);
+	}
+	~ObjectPool()
+	{
+		for (uint32_t i = 0; i < magazineCount; i++)
+			for (std::size_t j = 0; j < magazines[i].count; j++)
+				delete magazines[i].objects[j];
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	// Two magazines per thread: when "loaded" runs dry (or overflows) and
+	// "previous" can take over, the thread switches to it without going to the depot.
+	// A thread takes full magazines when no empty ones are left; when the depot has
+	// no magazines at all, it gets none and its calls go straight to new and delete
+	struct ThreadCache
+	{
+		static const uint32_t none = UINT32_MAX;
+
+		explicit ThreadCache(ObjectPool& pool) : pool(pool), loaded(none), previous(none)
+		{
+			if (!pool.takeMagazine(loaded))
+				return;
+			if (!pool.takeMagazine(previous))
+			{
+				pool.returnMagazine(loaded);
+				loaded = none;
+			}
+		}
+		~ThreadCache()
+		{
+			if (loaded == none)
+				return;
+			pool.returnMagazine(loaded);
+			pool.returnMagazine(previous);
+		}
+
+		ObjectPool& pool;
+		uint32_t loaded;
+		uint32_t previous;
+	};
+
+	ThreadCache& localCache()
+	{
+		thread_local ThreadCache cache(*this);
+		return cache;
+	}
+	bool takeMagazine(uint32_t& index)
+	{
+		return emptyMagazines.pop(index) || fullMagazines.pop(index);
+	}
+	void returnMagazine(uint32_t index)
+	{
+		if (magazines[index].count > 0)
+			fullMagazines.push(index);
+		else
+			emptyMagazines.push(index);
+	}
+
+	static const uint32_t magazineCount = 4096;
+
+	std::unique_ptr<Magazine[]> magazines;
+	MagazineStack fullMagazines;
+	MagazineStack emptyMagazines;
+};
+
+#pragma region Benchmark
+
+// The pool from ObjectPool.cpp (without console output),
+// guarded by a mutex so that it can be shared between threads
+class ListPool
+{
+public:
+	~ListPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	Resource* getResource()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (resources.empty())
+			return new Resource();
+
+		Resource* object = resources.front();
+		resources.pop_front();
+		return object;
+	}
+	void releaseResource(Resource* object)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		object->reset();
+		resources.push_back(object);
+	}
+
+private:
+	std::mutex mutex;
+	std::list<Resource*> resources;
+};
+
+struct HeapPool
+{
+	Resource* getResource()					{ return new Resource(); }
+	void releaseResource(Resource* object)	{ delete object; }
+};
+
+// Every thread repeatedly takes a handful of objects and gives them back;
+// the result is the number of acquire/release pairs per second
+template<class Pool>
+double measure(Pool& pool, unsigned threads)
+{
+	const int rounds = 50000;
+	const int batch = 8;
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&pool]()
+		{
+			Resource* held[batch];
+			for (int i = 0; i < rounds; i++)
+			{
+				for (int j = 0; j < batch; j++)
+				{
+					held[j] = pool.getResource();
+					held[j]->setValue(j);
+				}
+				for (int j = 0; j < batch; j++)
+					pool.releaseResource(held[j]);
+			}
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return double(threads) * rounds * batch / elapsed.count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	Resource* one = pool.getResource();
+	one->setValue(10);
+	std::cout << "one = " << one->getValue() << " [" << one << "]" << std::endl;
+	pool.releaseResource(one);
+
+	Resource* two = pool.getResource();
+	std::cout << "two = " << two->getValue() << " [" << two << "]" << std::endl;
+	pool.releaseResource(two);
+	// ...
+
+	std::cout << std::endl << "Acquire/release pairs per second, millions:" << std::endl;
+	std::cout << "threads\tlist+mutex\tnew/delete\tthread cache" << std::endl;
+
+	unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= hardware; threads *= 2)
+	{
+		ListPool listPool;
+		HeapPool heapPool;
+
+		std::cout << threads
+			<< "\t" << measure(listPool, threads) / 1e6
+			<< "\t\t" << measure(heapPool, threads) / 1e6
+			<< "\t\t" << measure(pool, threads) / 1e6 << std::endl;
+	}
+
+	// Once every empty magazine is filled, a new thread starts with full ones
+	std::vector<Resource*> objects(140000);
+	for (auto& object : objects)
+		object = pool.getResource();
+	for (auto object : objects)
+		pool.releaseResource(object);
+
+	std::thread([&pool]()
+	{
+		Resource* three = pool.getResource();
+		three->setValue(30);
+		std::cout << std::endl << "new thread: three = " << three->getValue() << " [" << three << "]" << std::endl;
+		pool.releaseResource(three);
+	}).join();
+
+	return 0;
+}
@@ -0,0 +1,350 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant lives in a POSIX shared-memory segment, so several processes share one
+ * warm pool. The segment may be mapped at a different address in every process, so
+ * the free list links slots by index instead of by pointer. Each slot remembers the
+ * process that holds it, which lets a survivor take back objects of a crashed process.
+ *
+ * POSIX only (shm_open, mmap, fork).
+ *
+ */
+
+#include<iostream>
+#include<atomic>
+#include<chrono>
+#include<new>
+#include<type_traits>
+#include<cstdint>
+#include<cstddef>
+#include<cerrno>
+#include<csignal>
+#include<fcntl.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/types.h>
+#include<sys/wait.h>
+#include<unistd.h>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * A shared-memory pool is used when several processes on one machine need the same
+ * expensive objects, and each of them building its own copies costs time and memory.
+ *
+ */
+
+// Reusable object. It is placed in shared memory, so it must not
+// contain pointers or anything else which is only valid in one process
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+static_assert(std::is_trivially_copyable<Resource>::value, "Resource must be placeable in shared memory");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics in shared memory must be lock-free");
+
+// Reusable Pool in a shared-memory segment
+class SharedObjectPool
+{
+public:
+	// Creates the segment or attaches to the one created by another process.
+	// Attaching fails if the segment was created with another capacity, or if its
+	// creator died or did not finish it in time; such a segment can be unlinked
+	static SharedObjectPool* open(const char* name, uint32_t capacity)
+	{
+		std::size_t size = sizeof(Header) + sizeof(Slot) * capacity;
+		auto deadline = std::chrono::steady_clock::now() + attachTimeout;
+		bool creator = true;
+
+		int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+		if (fd == -1 && errno == EEXIST)
+		{
+			creator = false;
+			fd = shm_open(name, O_RDWR, 0600);
+		}
+		if (fd == -1)
+			return nullptr;
+
+		if (creator && ftruncate(fd, off_t(size)) == -1)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		// Touching the mapping before the creator has sized the segment would raise SIGBUS.
+		// The creator sizes it in one step, so any size but 0 is the final one
+		struct stat info;
+		while (!creator && fstat(fd, &info) == 0 && info.st_size == 0
+			&& std::chrono::steady_clock::now() < deadline)
+			usleep(100);
+		if (!creator && (fstat(fd, &info) == -1 || info.st_size != off_t(size)))
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (memory == MAP_FAILED)
+			return nullptr;
+
+		SharedObjectPool* pool = new SharedObjectPool(static_cast<Header*>(memory), size);
+		if (creator)
+			pool->build(capacity);
+		else if (!pool->waitUntilBuilt(deadline))
+		{
+			delete pool;
+			return nullptr;
+		}
+
+		if (pool->header->capacity != capacity)
+		{
+			delete pool;
+			return nullptr;
+		}
+		return pool;
+	}
+	static void unlink(const char* name)
+	{
+		shm_unlink(name);
+	}
+	~SharedObjectPool()
+	{
+		munmap(header, size);
+	}
+	SharedObjectPool(const SharedObjectPool&)				= delete;
+	SharedObjectPool& operator = (SharedObjectPool&)		= delete;
+
+	// Returns nullptr when every object is in use
+	Resource* getResource()
+	{
+		uint32_t index;
+		if (!pop(index))
+			return nullptr;
+
+		slots()[index].owner.store(int32_t(getpid()), std::memory_order_relaxed);
+		return &slots()[index].object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		Slot* slot = reinterpret_cast<Slot*>(object);
+		slot->owner.store(0, std::memory_order_relaxed);
+		push(uint32_t(slot - slots()));
+	}
+
+	// Returns objects held by processes which no longer exist. An object is lost
+	// if its holder died between taking it and recording itself, and is kept
+	// if the pid of the dead holder has already been reused
+	uint32_t recover()
+	{
+		uint32_t recovered = 0;
+		for (uint32_t i = 0; i < header->capacity; i++)
+		{
+			Slot& slot = slots()[i];
+			int32_t owner = slot.owner.load(std::memory_order_relaxed);
+			if (owner == 0 || kill(owner, 0) == 0 || errno != ESRCH)
+				continue;
+
+			// Only one of the recovering processes wins the slot
+			if (slot.owner.compare_exchange_strong(owner, 0))
+			{
+				slot.object.reset();
+				push(i);
+				recovered++;
+			}
+		}
+		return recovered;
+	}
+	uint32_t capacity()
+	{
+		return header->capacity;
+	}
+
+private:
+	static const uint32_t builtMagic = 0x504F4F4C;
+	static constexpr std::chrono::seconds attachTimeout{ 5 };
+
+	struct Header
+	{
+		std::atomic<uint32_t> magic;		// set once the creator finished the layout
+		std::atomic<int32_t> creator;		// pid of the process building the layout
+		uint32_t capacity;
+		std::atomic<uint64_t> freeHead;		// version tag and slot index + 1
+	};
+
+	// The object is the first member, so a pointer to it is a pointer to the slot
+	struct Slot
+	{
+		Resource object;
+		std::atomic<uint32_t> next;			// index + 1 of the next free slot
+		std::atomic<int32_t> owner;			// pid of the holder, 0 when free
+	};
+
+	SharedObjectPool(Header* header, std::size_t size) : header(header), size(size) {}
+
+	Slot* slots()
+	{
+		return reinterpret_cast<Slot*>(header + 1);
+	}
+	void build(uint32_t capacity)
+	{
+		::new (static_cast<void*>(header)) Header();
+		header->creator.store(int32_t(getpid()), std::memory_order_relaxed);
+		header->capacity = capacity;
+		header->freeHead.store(0, std::memory_order_relaxed);
+
+		// Expensive objects are built once, by the first process
+		for (uint32_t i = 0; i < capacity; i++)
+		{
+			::new (static_cast<void*>(&slots()[i])) Slot();
+			push(i);
+		}
+
+		header->magic.store(builtMagic, std::memory_order_release);
+	}
+	// Gives up when the creator no longer exists or the deadline has passed.
+	// The magic is checked once more, as the creator may have finished and exited
+	bool waitUntilBuilt(std::chrono::steady_clock::time_point deadline)
+	{
+		while (header->magic.load(std::memory_order_acquire) != builtMagic)
+		{
+			int32_t creator = header->creator.load(std::memory_order_relaxed);
+			bool creatorDied = creator != 0 && kill(creator, 0) == -1 && errno == ESRCH;
+			if (creatorDied || std::chrono::steady_clock::now() >= deadline)
+				return header->magic.load(std::memory_order_acquire) == builtMagic;
+			usleep(100);
+		}
+		return true;
+	}
+
+	// Treiber stack over slot indices, with a version tag against ABA
+	void push(uint32_t index)
+	{
+		uint64_t old = header->freeHead.load(std::memory_order_relaxed);
+		uint64_t desired;
+		do
+		{
+			slots()[index].next.store(uint32_t(old), std::memory_order_relaxed);
+			desired = ((old >> 32) + 1) << 32 | (index + 1);
+		} while (!header->freeHead.compare_exchange_weak(old, desired,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+	bool pop(uint32_t& index)
+	{
+		uint64_t old = header->freeHead.load(std::memory_order_acquire);
+		uint64_t desired;
+		do
+		{
+			uint32_t link = uint32_t(old);
+			if (link == 0)
+				return false;
+			uint32_t next = slots()[link - 1].next.load(std::memory_order_relaxed);
+			desired = ((old >> 32) + 1) << 32 | next;
+		} while (!header->freeHead.compare_exchange_weak(old, desired,
+			std::memory_order_acquire, std::memory_order_acquire));
+
+		index = uint32_t(old) - 1;
+		return true;
+	}
+
+	Header* header;
+	std::size_t size;
+};
+
+
+int main()
+{
+	const char* name = "/design-patterns-object-pool";
+	SharedObjectPool::unlink(name);
+
+	SharedObjectPool* pool = SharedObjectPool::open(name, 8);
+	if (pool == nullptr)
+	{
+		std::cout << "Shared memory is not available" << std::endl;
+		return 1;
+	}
+
+	// Workers attach to the warm pool instead of building their own
+	const int workers = 4;
+	for (int w = 0; w < workers; w++)
+	{
+		if (fork() == 0)
+		{
+			SharedObjectPool* shared = SharedObjectPool::open(name, 8);
+			if (shared == nullptr)
+				_exit(2);
+
+			for (int i = 0; i < 10000; i++)
+			{
+				Resource* object = shared->getResource();
+				if (object == nullptr)
+					continue;
+				object->setValue(w);
+				shared->releaseResource(object);
+			}
+
+			// The last worker "crashes" while holding two objects
+			if (w == workers - 1)
+			{
+				shared->getResource();
+				shared->getResource();
+				_exit(1);
+			}
+
+			delete shared;
+			_exit(0);
+		}
+	}
+	for (int w = 0; w < workers; w++)
+		wait(nullptr);
+
+	uint32_t available = 0;
+	Resource* held[8];
+	while (available < pool->capacity() && (held[available] = pool->getResource()) != nullptr)
+		available++;
+	std::cout << "available after workers exited: " << available << " of " << pool->capacity() << std::endl;
+	for (uint32_t i = 0; i < available; i++)
+		pool->releaseResource(held[i]);
+
+	std::cout << "recovered from the crashed worker: " << pool->recover() << std::endl;
+
+	available = 0;
+	while (available < pool->capacity() && (held[available] = pool->getResource()) != nullptr)
+		available++;
+	std::cout << "available after recovery: " << available << " of " << pool->capacity() << std::endl;
+	for (uint32_t i = 0; i < available; i++)
+		pool->releaseResource(held[i]);
+
+	delete pool;
+	SharedObjectPool::unlink(name);
+
+	return 0;
+}
@@ -0,0 +1,382 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * In this variant the pool carves objects out of large contiguous slabs and keeps the
+ * free objects in an intrusive list: the link lives in the slot next to the object, so
+ * releasing an object never allocates and pooled objects sit close together in memory.
+ *
+ */
+
+#include<iostream>
+#include<list>
+#include<vector>
+#include<string>
+#include<chrono>
+#include<random>
+#include<cstddef>
+#include<cstdint>
+#include<cstdlib>
+#include<new>
+#ifdef __linux__
+#include<cstring>
+#include<linux/perf_event.h>
+#include<sys/ioctl.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#endif
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Slab storage is used when objects are acquired and released at a high rate, and both
+ * the allocator calls and the scattering of objects across the heap become noticeable.
+ *
+ */
+
+// Counts calls of the global allocator to show the heap traffic of each pool
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	if (void* p = std::malloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	Resource* getResource()
+	{
+		if (freeList == nullptr)
+			addSlab();
+
+		Slot* slot = freeList;
+		freeList = slot->next;
+
+		return &slot->object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		// The object is the first member of a standard-layout slot,
+		// so the slot starts at the same address
+		Slot* slot = reinterpret_cast<Slot*>(object);
+		slot->next = freeList;
+		freeList = slot;
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		while (slabs != nullptr)
+		{
+			Slab* next = slabs->next;
+			delete slabs;
+			slabs = next;
+		}
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	// A pooled object together with the link of the free list
+	struct Slot
+	{
+		Resource object;
+		Slot* next;
+	};
+
+	// One contiguous block of slots, obtained with a single allocation
+	struct Slab
+	{
+		static const std::size_t size = 1024;
+
+		Slab* next;
+		Slot slots[size];
+	};
+
+	void addSlab()
+	{
+		Slab* slab = new Slab();
+		slab->next = slabs;
+		slabs = slab;
+
+		// Thread the free list from the end of the slab, so that
+		// objects are handed out in address order
+		for (std::size_t i = Slab::size; i-- > 0;)
+		{
+			slab->slots[i].next = freeList;
+			freeList = &slab->slots[i];
+		}
+	}
+
+	Slab* slabs = nullptr;
+	Slot* freeList = nullptr;
+};
+
+#pragma region Benchmark
+
+// The pool from ObjectPool.cpp without console output
+class ListPool
+{
+public:
+	~ListPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	Resource* getResource()
+	{
+		if (resources.empty())
+			return new Resource();
+
+		Resource* object = resources.front();
+		resources.pop_front();
+		return object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+		resources.push_back(object);
+	}
+
+private:
+	std::list<Resource*> resources;
+};
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+// Cache counters of the calling thread in user mode, enabled only around
+// a measured loop. Linux only (perf_event_open); they are unavailable elsewhere,
+// in virtual machines without a PMU and when perf_event_paranoid forbids them
+class PerfCounters
+{
+public:
+	enum Event { CacheReferences = 0, CacheMisses, Events };
+
+	PerfCounters()
+	{
+		for (int e = 0; e < Events; e++)
+			fds[e] = open(Event(e));
+	}
+	~PerfCounters()
+	{
+		for (int fd : fds)
+			close(fd);
+	}
+	PerfCounters(const PerfCounters&)				= delete;
+	PerfCounters& operator = (const PerfCounters&)	= delete;
+
+	bool available() const
+	{
+		return fds[CacheReferences] != -1 && fds[CacheMisses] != -1;
+	}
+	void start()
+	{
+		for (int fd : fds)
+			control(fd, true);
+	}
+	void stop()
+	{
+		for (int fd : fds)
+			control(fd, false);
+	}
+	long long value(Event e) const
+	{
+		return read(fds[e]);
+	}
+
+private:
+#ifdef __linux__
+	static int open(Event e)
+	{
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = e == CacheReferences ? PERF_COUNT_HW_CACHE_REFERENCES : PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+	}
+	static void close(int fd)
+	{
+		if (fd != -1)
+			::close(fd);
+	}
+	static void control(int fd, bool enable)
+	{
+		if (enable)
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, enable ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+	}
+	static long long read(int fd)
+	{
+		std::uint64_t count = 0;
+		if (::read(fd, &count, sizeof(count)) != sizeof(count))
+			return -1;
+		return (long long)count;
+	}
+#else
+	static int open(Event)				{ return -1; }
+	static void close(int)				{}
+	static void control(int, bool)		{}
+	static long long read(int)			{ return -1; }
+#endif
+
+	int fds[Events];
+};
+
+// Cache references and misses per operation of the last measured loop
+void printCounters(const PerfCounters& counters, double operations, const char* operation)
+{
+	if (counters.available())
+		std::cout << counters.value(PerfCounters::CacheReferences) / operations << " cache references, "
+			<< counters.value(PerfCounters::CacheMisses) / operations << " cache misses per " << operation;
+	else
+		std::cout << "hardware counters unavailable";
+	std::cout << std::endl;
+}
+
+// Keeps a working set of live objects and replaces random ones with fresh ones,
+// then walks the objects. The counters cover only the churn and the traversal,
+// not filling the working set
+template<class Pool>
+void churn(const char* name, Pool& pool)
+{
+	const std::size_t live = 100000;
+	const std::size_t cycles = 2000000;
+	const int passes = 20;
+
+	std::vector<Resource*> objects(live);
+	std::mt19937 random(42);
+	PerfCounters counters;
+
+	for (auto& object : objects)
+		object = pool.getResource();
+
+	std::size_t before = allocations;
+	counters.start();
+	for (std::size_t i = 0; i < cycles; i++)
+	{
+		std::size_t index = random() % live;
+		pool.releaseResource(objects[index]);
+		objects[index] = pool.getResource();
+		objects[index]->setValue(int(i));
+	}
+	counters.stop();
+	std::size_t churnAllocations = allocations - before;
+
+	std::cout << name << std::endl
+		<< "\tchurn:\t\t" << churnAllocations << " allocations, ";
+	printCounters(counters, double(cycles), "cycle");
+
+	long long sum = 0;
+	auto start = std::chrono::steady_clock::now();
+	counters.start();
+	for (int pass = 0; pass < passes; pass++)
+		for (auto object : objects)
+			sum += object->getValue();
+	counters.stop();
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	sink = sum;
+
+	std::cout << "\ttraversal:\t" << elapsed.count() / (double(passes) * live) << " ns/object, ";
+	printCounters(counters, double(passes) * live, "object");
+
+	for (auto object : objects)
+		pool.releaseResource(object);
+}
+
+#pragma endregion
+
+
+int main(int argc, char* argv[])
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	Resource* one = pool.getResource();
+	Resource* two = pool.getResource();
+	one->setValue(10);
+	two->setValue(20);
+	std::cout << "one = " << one->getValue() << " [" << one << "]" << std::endl;
+	std::cout << "two = " << two->getValue() << " [" << two << "]" << std::endl;
+
+	pool.releaseResource(one);
+	pool.releaseResource(two);
+
+	std::cout << std::endl;
+
+	one = pool.getResource();
+	std::cout << "one = " << one->getValue() << " [" << one << "]" << std::endl;
+	two = pool.getResource();
+	std::cout << "two = " << two->getValue() << " [" << two << "]" << std::endl;
+	pool.releaseResource(one);
+	pool.releaseResource(two);
+	// ...
+
+	std::cout << std::endl;
+
+	// "list" or "slab" runs only that pool
+	std::string only = argc > 1 ? argv[1] : "";
+	if (only.empty() || only == "list")
+	{
+		ListPool listPool;
+		churn("list", listPool);
+	}
+	if (only.empty() || only == "slab")
+		churn("slab", pool);
+
+	return 0;
+}
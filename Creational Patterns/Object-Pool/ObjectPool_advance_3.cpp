@@ -0,0 +1,228 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant is a class template: one ObjectPool<T, Policy> serves any pooled type,
+ * and the policy decides at compile time how a released object is made reusable.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<string>
+#include<chrono>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * A pool template is used when several unrelated types are expensive to create
+ * and each of them needs its own way of being cleaned before reuse.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Reusable object without reset(): it is restored by running the constructor again
+class Buffer
+{
+public:
+	Buffer() : size(0), data(4096, '\0') {}
+
+	void append(char c)
+	{
+		data[size++ % data.size()] = c;
+	}
+	std::size_t length()
+	{
+		return this->size;
+	}
+	// ...
+
+private:
+	std::size_t size;
+	std::string data;
+};
+
+// Trivially reusable object: whoever acquires it overwrites every field
+struct Point
+{
+	double x;
+	double y;
+	double z;
+};
+
+// Detects at compile time whether T has a reset() member function
+#pragma region Traits
+
+template<class T, class = void>
+struct has_reset : std::false_type {};
+
+template<class T>
+struct has_reset<T, std::void_t<decltype(std::declval<T&>().reset())>> : std::true_type {};
+
+#pragma endregion
+
+// Policies which bring a released object back to its initial state
+#pragma region Policies
+
+// Calls T::reset() on the object in place
+struct ResetPolicy
+{
+	template<class T>
+	static void recycle(T* object)
+	{
+		object->reset();
+	}
+};
+
+// Destroys the object and constructs a new one in the same storage
+struct ReconstructPolicy
+{
+	template<class T>
+	static void recycle(T* object)
+	{
+		object->~T();
+		::new (static_cast<void*>(object)) T();
+	}
+};
+
+// Leaves the object as it is
+struct NoopPolicy
+{
+	template<class T>
+	static void recycle(T*) {}
+};
+
+// Used when no policy is given: reset() if the type has one, the constructor otherwise
+template<class T>
+using DefaultPolicy = std::conditional_t<has_reset<T>::value, ResetPolicy, ReconstructPolicy>;
+
+#pragma endregion
+
+// Reusable Pool
+template<class T, class Policy = DefaultPolicy<T>>
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	T* getResource()
+	{
+		if (resources.empty())
+			return new T();
+
+		T* object = resources.back();
+		resources.pop_back();
+		return object;
+	}
+	void releaseResource(T* object)
+	{
+		Policy::recycle(object);
+		resources.push_back(object);
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::vector<T*> resources;
+};
+
+#pragma region Benchmark
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+// Average cost of one acquire/use/release cycle, in nanoseconds
+template<class T, class Policy, class Use>
+double measure(Use use)
+{
+	const int cycles = 1000000;
+	ObjectPool<T, Policy>& pool = ObjectPool<T, Policy>::getInstance();
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < cycles; i++)
+	{
+		T* object = pool.getResource();
+		sink = use(object, i);
+		pool.releaseResource(object);
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / cycles;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	static_assert(has_reset<Resource>::value, "Resource is reset in place");
+	static_assert(!has_reset<Buffer>::value, "Buffer is reconstructed");
+
+	ObjectPool<Resource>& pool = ObjectPool<Resource>::getInstance();
+
+	Resource* one = pool.getResource();
+	one->setValue(10);
+	std::cout << "one = " << one->getValue() << " [" << one << "]" << std::endl;
+	pool.releaseResource(one);
+
+	Resource* two = pool.getResource();
+	std::cout << "two = " << two->getValue() << " [" << two << "]" << std::endl;
+	pool.releaseResource(two);
+	// ...
+
+	auto useResource = [](Resource* object, int i) { object->setValue(i); return object->getValue(); };
+	auto useBuffer = [](Buffer* object, int i) { object->append(char(i)); return (long long)object->length(); };
+	auto usePoint = [](Point* object, int i) { *object = Point{ double(i), 1.0, 2.0 }; return (long long)object->x; };
+
+	std::cout << std::endl << "Nanoseconds per acquire/release cycle:" << std::endl;
+	std::cout << "Resource\treset:       " << measure<Resource, ResetPolicy>(useResource) << std::endl;
+	std::cout << "Resource\treconstruct: " << measure<Resource, ReconstructPolicy>(useResource) << std::endl;
+	std::cout << "Buffer\t\treconstruct: " << measure<Buffer, ReconstructPolicy>(useBuffer) << std::endl;
+	std::cout << "Point\t\treconstruct: " << measure<Point, ReconstructPolicy>(usePoint) << std::endl;
+	std::cout << "Point\t\tnothing:     " << measure<Point, NoopPolicy>(usePoint) << std::endl;
+
+	return 0;
+}
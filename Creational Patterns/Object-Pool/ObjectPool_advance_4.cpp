@@ -0,0 +1,245 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * In this variant the pool hands out move-only handles instead of raw pointers.
+ * A handle gives its object back to the pool when it is destroyed, so a forgotten
+ * releaseResource() can no longer shrink the pool.
+ *
+ */
+
+#include<iostream>
+#include<list>
+#include<chrono>
+#include<utility>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Handles are used when objects are passed between functions and it is easy to lose
+ * track of who must give them back.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+template<class T, class Recycler>
+class Pooled;
+
+// Default recycler of a handle: returns the object to the pool
+struct ReturnToPool
+{
+	void operator()(Resource* object) const;
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	template<class Recycler = ReturnToPool>
+	Pooled<Resource, Recycler> acquire()
+	{
+		return Pooled<Resource, Recycler>(getResource());
+	}
+	Resource* getResource()
+	{
+		if (resources.empty())
+			return new Resource();
+
+		Resource* object = this->resources.front();
+		this->resources.pop_front();
+		return object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+		this->resources.push_back(object);
+	}
+	std::size_t size()
+	{
+		return resources.size();
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::list<Resource*> resources;
+};
+
+void ReturnToPool::operator()(Resource* object) const
+{
+	ObjectPool::getInstance().releaseResource(object);
+}
+
+// Move-only owner of a pooled object. The recycler is stateless and
+// is stored as an empty base, so the handle is as small as a raw pointer
+template<class T, class Recycler = ReturnToPool>
+class Pooled : private Recycler
+{
+public:
+	Pooled() : object(nullptr) {}
+	explicit Pooled(T* object) : object(object) {}
+	Pooled(Pooled&& other) noexcept : object(other.object)
+	{
+		other.object = nullptr;
+	}
+	// The object held now goes back to the pool at once, as with std::unique_ptr
+	Pooled& operator = (Pooled&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (object != nullptr)
+				Recycler::operator()(object);
+			object = other.object;
+			other.object = nullptr;
+		}
+		return *this;
+	}
+	Pooled(const Pooled&)				= delete;
+	Pooled& operator = (const Pooled&)	= delete;
+	~Pooled()
+	{
+		if (object != nullptr)
+			Recycler::operator()(object);
+	}
+
+	T* operator->() const	{ return object; }
+	T& operator*() const	{ return *object; }
+	T* get() const			{ return object; }
+	explicit operator bool() const { return object != nullptr; }
+
+	// Gives up ownership without returning the object to the pool
+	T* release()
+	{
+		T* p = object;
+		object = nullptr;
+		return p;
+	}
+
+private:
+	T* object;
+};
+
+// Custom recycler: an object left in a broken state is destroyed instead of being reused
+struct DropPoisoned
+{
+	void operator()(Resource* object) const
+	{
+		if (object->getValue() < 0)
+		{
+			std::cout << "Dropping poisoned [" << object << "]" << std::endl;
+			delete object;
+		}
+		else
+		{
+			ObjectPool::getInstance().releaseResource(object);
+		}
+	}
+};
+
+static_assert(sizeof(Pooled<Resource>) == sizeof(Resource*), "handle must be pointer-sized");
+static_assert(sizeof(Pooled<Resource, DropPoisoned>) == sizeof(Resource*), "handle must be pointer-sized");
+
+#pragma region Benchmark
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+template<class Cycle>
+double measure(Cycle cycle)
+{
+	const int cycles = 5000000;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < cycles; i++)
+		cycle(i);
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / cycles;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	{
+		Pooled<Resource> one = pool.acquire();
+		one->setValue(10);
+		std::cout << "one = " << one->getValue() << " [" << one.get() << "]" << std::endl;
+
+		Pooled<Resource> moved = std::move(one);
+		std::cout << "moved = " << moved->getValue() << " [" << moved.get() << "]" << std::endl;
+	}
+	std::cout << "free objects: " << pool.size() << std::endl;
+
+	{
+		Pooled<Resource, DropPoisoned> two = pool.acquire<DropPoisoned>();
+		two->setValue(-1);
+	}
+	std::cout << "free objects: " << pool.size() << std::endl;
+	// ...
+
+	double raw = measure([&pool](int i)
+	{
+		Resource* object = pool.getResource();
+		object->setValue(i);
+		sink = object->getValue();
+		pool.releaseResource(object);
+	});
+	double handle = measure([&pool](int i)
+	{
+		Pooled<Resource> object = pool.acquire();
+		object->setValue(i);
+		sink = object->getValue();
+	});
+
+	std::cout << std::endl << "Nanoseconds per acquire/release cycle:" << std::endl;
+	std::cout << "raw pointer: " << raw << std::endl;
+	std::cout << "handle:      " << handle << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant limits the number of objects the pool may create. When all of them are
+ * in use, a client either fails at once, waits until an object comes back, or waits
+ * no longer than a given timeout. Waiting clients are served in arrival order.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<deque>
+#include<mutex>
+#include<condition_variable>
+#include<thread>
+#include<chrono>
+#include<algorithm>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * A bounded pool is used when the number of objects created is limited, and under
+ * a spike of requests clients should wait instead of exhausting memory.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Reusable Pool with a fixed capacity
+class BoundedObjectPool
+{
+public:
+	explicit BoundedObjectPool(std::size_t capacity) : capacity(capacity), created(0) {}
+	~BoundedObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	BoundedObjectPool(const BoundedObjectPool&)				= delete;
+	BoundedObjectPool& operator = (BoundedObjectPool&)		= delete;
+
+	// Returns nullptr at once when every object is in use
+	Resource* tryAcquire()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return take();
+	}
+	// Waits as long as it takes for an object to come back
+	Resource* acquire()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (Resource* object = take())
+			return object;
+
+		Waiter waiter;
+		waiters.push_back(&waiter);
+		waiter.ready.wait(lock, [&waiter]() { return waiter.object != nullptr; });
+
+		return waiter.object;
+	}
+	// Waits no longer than timeout, then returns nullptr
+	template<class Rep, class Period>
+	Resource* acquireFor(std::chrono::duration<Rep, Period> timeout)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (Resource* object = take())
+			return object;
+
+		Waiter waiter;
+		waiters.push_back(&waiter);
+		if (!waiter.ready.wait_for(lock, timeout, [&waiter]() { return waiter.object != nullptr; }))
+			waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+
+		return waiter.object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (waiters.empty())
+		{
+			resources.push_back(object);
+			return;
+		}
+
+		// The object goes straight to the oldest waiter, and only that thread
+		// is woken up, so no other waiter can overtake it
+		Waiter* waiter = waiters.front();
+		waiters.pop_front();
+		waiter->object = object;
+		waiter->ready.notify_one();
+	}
+
+private:
+	// A waiting client. It lives on the stack of the waiting thread
+	// and has its own condition variable
+	struct Waiter
+	{
+		Resource* object = nullptr;
+		std::condition_variable ready;
+	};
+
+	// Takes a free object or creates one while under capacity; requires the lock
+	Resource* take()
+	{
+		if (!resources.empty())
+		{
+			Resource* object = resources.back();
+			resources.pop_back();
+			return object;
+		}
+		if (created < capacity)
+		{
+			created++;
+			return new Resource();
+		}
+		return nullptr;
+	}
+
+	const std::size_t capacity;
+	std::size_t created;
+	std::mutex mutex;
+	std::vector<Resource*> resources;
+	std::deque<Waiter*> waiters;
+};
+
+#pragma region Benchmark
+
+// Many clients compete for a few objects; each one measures how long it waits in acquire()
+void stress(BoundedObjectPool& pool, unsigned clients, int rounds)
+{
+	std::vector<std::vector<double>> latencies(clients);
+	std::vector<std::thread> workers;
+
+	for (unsigned c = 0; c < clients; c++)
+	{
+		workers.emplace_back([&pool, &latencies, c, rounds]()
+		{
+			latencies[c].reserve(rounds);
+			for (int i = 0; i < rounds; i++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				Resource* object = pool.acquire();
+				std::chrono::duration<double, std::micro> waited = std::chrono::steady_clock::now() - start;
+				latencies[c].push_back(waited.count());
+
+				object->setValue(i);
+				std::this_thread::sleep_for(std::chrono::microseconds(20));
+				pool.releaseResource(object);
+			}
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+
+	std::vector<double> all;
+	for (auto& l : latencies)
+		all.insert(all.end(), l.begin(), l.end());
+	std::sort(all.begin(), all.end());
+
+	auto percentile = [&all](double p) { return all[std::size_t(p * (all.size() - 1))]; };
+	std::cout << "acquire latency, us: p50 " << percentile(0.50)
+		<< "  p99 " << percentile(0.99)
+		<< "  p99.9 " << percentile(0.999)
+		<< "  max " << all.back() << std::endl;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	BoundedObjectPool pool(2);
+
+	Resource* one = pool.tryAcquire();
+	Resource* two = pool.tryAcquire();
+	std::cout << "one [" << one << "], two [" << two << "]" << std::endl;
+	std::cout << "third tryAcquire: " << pool.tryAcquire() << std::endl;
+	std::cout << "third acquireFor(10ms): " << pool.acquireFor(std::chrono::milliseconds(10)) << std::endl;
+
+	std::thread late([&pool, one]()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		pool.releaseResource(one);
+	});
+	Resource* three = pool.acquire();
+	std::cout << "third acquire after release: [" << three << "]" << std::endl;
+	late.join();
+
+	pool.releaseResource(two);
+	pool.releaseResource(three);
+	// ...
+
+	std::cout << std::endl << "32 clients, 4 objects:" << std::endl;
+	BoundedObjectPool saturated(4);
+	stress(saturated, 32, 200);
+
+	return 0;
+}
@@ -0,0 +1,294 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant is observable. Instead of printing from getResource(), the pool counts
+ * hits, misses, releases, live objects and the peak number of objects in use with
+ * relaxed atomics, and can record acquire latency in a log-linear histogram.
+ * Everything is read through a snapshot that can be exported to a metrics system.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<mutex>
+#include<atomic>
+#include<thread>
+#include<chrono>
+#include<cstdint>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Pool telemetry is used to choose the pool size and to see whether the pool actually
+ * saves object creation under the real load.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Histogram with 8 linear buckets per power of two (HDR-style), which keeps
+// the relative error of any recorded value below 12.5%
+class LatencyHistogram
+{
+public:
+	static const std::size_t bucketCount = 8 * 62;
+
+	void record(uint64_t nanoseconds)
+	{
+		buckets[indexOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+	}
+	void copyTo(std::vector<uint64_t>& out) const
+	{
+		out.resize(bucketCount);
+		for (std::size_t i = 0; i < bucketCount; i++)
+			out[i] = buckets[i].load(std::memory_order_relaxed);
+	}
+
+	// Smallest value which falls into the bucket
+	static uint64_t lowerBound(std::size_t index)
+	{
+		if (index < 8)
+			return index;
+		std::size_t exponent = index / 8 + 2;
+		return (8 + index % 8) << (exponent - 3);
+	}
+
+private:
+	static std::size_t indexOf(uint64_t value)
+	{
+		if (value < 8)
+			return std::size_t(value);
+
+		std::size_t exponent = 3;
+		while (exponent < 63 && (value >> (exponent + 1)) != 0)
+			exponent++;
+
+		return (exponent - 2) * 8 + std::size_t((value >> (exponent - 3)) & 7);
+	}
+
+	std::atomic<uint64_t> buckets[bucketCount] = {};
+};
+
+// Copy of all pool counters at one moment
+struct PoolSnapshot
+{
+	uint64_t hits;				// objects taken from the pool
+	uint64_t misses;			// objects created because the pool was empty
+	uint64_t releases;			// objects given back
+	uint64_t live;				// objects created and not yet destroyed
+	uint64_t outstanding;		// objects in use right now
+	uint64_t peakOutstanding;	// the most objects ever in use at once
+	std::vector<uint64_t> latency;
+
+	// Approximate acquire latency (ns) below which the given share of calls fall
+	uint64_t latencyPercentile(double p) const
+	{
+		uint64_t total = 0;
+		for (auto count : latency)
+			total += count;
+		if (total == 0)
+			return 0;
+
+		uint64_t rank = uint64_t(p * (total - 1));
+		uint64_t seen = 0;
+		for (std::size_t i = 0; i < latency.size(); i++)
+		{
+			seen += latency[i];
+			if (seen > rank)
+				return LatencyHistogram::lowerBound(i);
+		}
+		return 0;
+	}
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	Resource* getResource()
+	{
+		bool timed = latencyTracking.load(std::memory_order_relaxed);
+		std::chrono::steady_clock::time_point start;
+		if (timed)
+			start = std::chrono::steady_clock::now();
+
+		Resource* object = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!resources.empty())
+			{
+				object = resources.back();
+				resources.pop_back();
+			}
+		}
+
+		if (object != nullptr)
+		{
+			hits.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			object = new Resource();
+			misses.fetch_add(1, std::memory_order_relaxed);
+			live.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		uint64_t inUse = outstanding.fetch_add(1, std::memory_order_relaxed) + 1;
+		uint64_t peak = peakOutstanding.load(std::memory_order_relaxed);
+		while (inUse > peak && !peakOutstanding.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+			;
+
+		if (timed)
+		{
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			latency.record(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+		}
+
+		return object;
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		// Counted before the object becomes visible to other threads,
+		// so the peak never includes an object that is both freed and reused
+		releases.fetch_add(1, std::memory_order_relaxed);
+		outstanding.fetch_sub(1, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		resources.push_back(object);
+	}
+
+	// Turns recording of acquire latency on or off; it costs two clock reads per call
+	void setLatencyTracking(bool enabled)
+	{
+		latencyTracking.store(enabled, std::memory_order_relaxed);
+	}
+	// Counters are read independently, so a snapshot taken under load
+	// may be off by the calls that are in progress
+	PoolSnapshot snapshot() const
+	{
+		PoolSnapshot s;
+		s.hits				= hits.load(std::memory_order_relaxed);
+		s.misses			= misses.load(std::memory_order_relaxed);
+		s.releases			= releases.load(std::memory_order_relaxed);
+		s.live				= live.load(std::memory_order_relaxed);
+		s.outstanding		= outstanding.load(std::memory_order_relaxed);
+		s.peakOutstanding	= peakOutstanding.load(std::memory_order_relaxed);
+		latency.copyTo(s.latency);
+		return s;
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::mutex mutex;
+	std::vector<Resource*> resources;
+
+	std::atomic<uint64_t> hits{ 0 };
+	std::atomic<uint64_t> misses{ 0 };
+	std::atomic<uint64_t> releases{ 0 };
+	std::atomic<uint64_t> live{ 0 };
+	std::atomic<uint64_t> outstanding{ 0 };
+	std::atomic<uint64_t> peakOutstanding{ 0 };
+	std::atomic<bool> latencyTracking{ false };
+	LatencyHistogram latency;
+};
+
+void print(const PoolSnapshot& s)
+{
+	std::cout << "hits " << s.hits
+		<< ", misses " << s.misses
+		<< ", releases " << s.releases
+		<< ", live " << s.live
+		<< ", outstanding " << s.outstanding
+		<< ", peak " << s.peakOutstanding << std::endl;
+}
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	Resource* one = pool.getResource();
+	Resource* two = pool.getResource();
+	pool.releaseResource(one);
+	pool.releaseResource(two);
+
+	one = pool.getResource();
+	two = pool.getResource();
+	pool.releaseResource(one);
+	pool.releaseResource(two);
+
+	print(pool.snapshot());
+	// ...
+
+	pool.setLatencyTracking(true);
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < 4; t++)
+	{
+		workers.emplace_back([&pool]()
+		{
+			for (int i = 0; i < 100000; i++)
+			{
+				Resource* object = pool.getResource();
+				object->setValue(i);
+				pool.releaseResource(object);
+			}
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+
+	PoolSnapshot s = pool.snapshot();
+	print(s);
+	std::cout << "acquire latency, ns: p50 " << s.latencyPercentile(0.50)
+		<< "  p99 " << s.latencyPercentile(0.99)
+		<< "  p99.9 " << s.latencyPercentile(0.999) << std::endl;
+
+	return 0;
+}
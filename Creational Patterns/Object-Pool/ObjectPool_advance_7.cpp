@@ -0,0 +1,227 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant adapts its size to the load. It can be filled in advance (in parallel),
+ * and a maintenance tick, called by the application away from the acquire path,
+ * shrinks the free list toward a target derived from an exponentially decayed peak
+ * of recent demand.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<mutex>
+#include<thread>
+#include<cmath>
+#include<algorithm>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Adaptive sizing is used when the load changes over the day, and objects kept for the
+ * peak should not occupy memory for the rest of the time.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Parameters of the adaptive sizing
+struct SizingPolicy
+{
+	std::size_t minIdle = 0;			// free objects which are never trimmed
+	double decay = 0.9;					// share of the remembered peak kept after each tick
+	std::size_t maxTrimPerTick = 64;	// limits the work done by one tick
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	void setPolicy(const SizingPolicy& policy)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->policy = policy;
+	}
+	Resource* getResource()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			outstanding++;
+			windowPeak = std::max(windowPeak, outstanding);
+
+			if (!resources.empty())
+			{
+				Resource* object = resources.back();
+				resources.pop_back();
+				return object;
+			}
+			misses++;
+		}
+		return new Resource();
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		outstanding--;
+		resources.push_back(object);
+	}
+
+	// Creates count objects ahead of demand, splitting the work between threads
+	void prewarm(std::size_t count, unsigned threads = 1)
+	{
+		threads = std::max(1u, threads);
+		std::vector<std::vector<Resource*>> parts(threads);
+		std::vector<std::thread> workers;
+
+		for (unsigned t = 0; t < threads; t++)
+		{
+			std::size_t share = count / threads + (t < count % threads ? 1 : 0);
+			workers.emplace_back([&parts, t, share]()
+			{
+				parts[t].reserve(share);
+				for (std::size_t i = 0; i < share; i++)
+					parts[t].push_back(new Resource());
+			});
+		}
+		for (auto& worker : workers)
+			worker.join();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& part : parts)
+			resources.insert(resources.end(), part.begin(), part.end());
+
+		// Prewarmed objects count as expected demand, so the first
+		// ticks do not trim them before the load arrives
+		decayedPeak = std::max(decayedPeak, double(resources.size() + outstanding));
+	}
+
+	// Maintenance step, called by the application at a regular interval
+	void tick()
+	{
+		std::vector<Resource*> surplus;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			decayedPeak = std::max(double(windowPeak), decayedPeak * policy.decay);
+			windowPeak = outstanding;
+
+			std::size_t demand = std::size_t(std::ceil(decayedPeak));
+			std::size_t target = std::max(policy.minIdle, demand > outstanding ? demand - outstanding : 0);
+
+			if (resources.size() > target)
+			{
+				std::size_t count = std::min(resources.size() - target, policy.maxTrimPerTick);
+				surplus.assign(resources.end() - count, resources.end());
+				resources.resize(resources.size() - count);
+			}
+		}
+
+		// Destruction may be expensive, so it happens outside the lock
+		for (auto object : surplus)
+			delete object;
+	}
+
+	std::size_t idle()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return resources.size();
+	}
+	std::size_t missCount()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return misses;
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::mutex mutex;
+	std::vector<Resource*> resources;
+	SizingPolicy policy;
+
+	std::size_t outstanding = 0;
+	std::size_t windowPeak = 0;		// the most objects in use since the last tick
+	double decayedPeak = 0.0;		// peak demand with older windows fading out
+	std::size_t misses = 0;
+};
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	SizingPolicy policy;
+	policy.minIdle = 8;
+	policy.decay = 0.95;
+	policy.maxTrimPerTick = 256;
+	pool.setPolicy(policy);
+
+	pool.prewarm(1000, 4);
+	std::cout << "prewarmed: " << pool.idle() << std::endl << std::endl;
+
+	// Two simulated "days" of 24 ticks: demand falls from the peak to a trough and back
+	std::cout << "tick\tdemand\tidle\tmisses" << std::endl;
+	std::vector<Resource*> inUse;
+	for (int t = 0; t < 48; t++)
+	{
+		std::size_t demand = std::size_t(500 + 450 * std::cos(t * 3.14159265 / 12));
+
+		for (std::size_t i = 0; i < demand; i++)
+			inUse.push_back(pool.getResource());
+		for (auto object : inUse)
+			pool.releaseResource(object);
+		inUse.clear();
+
+		pool.tick();
+
+		if (t % 4 == 0)
+			std::cout << t << "\t" << demand << "\t" << pool.idle() << "\t" << pool.missCount() << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * This variant adds bulk operations. A whole run of objects is moved in or out of the
+ * pool under one lock, and released objects are reset in one tight loop.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<mutex>
+#include<chrono>
+#include<algorithm>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Bulk operations are used when a client needs many objects at once, and the per-call
+ * cost of the pool becomes larger than the work done with each object.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	Resource* getResource()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!resources.empty())
+			{
+				Resource* object = resources.back();
+				resources.pop_back();
+				return object;
+			}
+		}
+		return new Resource();
+	}
+	void releaseResource(Resource* object)
+	{
+		object->reset();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		resources.push_back(object);
+	}
+
+	// Fills objects[0..count) with free objects, creating the ones the pool lacks
+	void acquireBulk(Resource** objects, std::size_t count)
+	{
+		std::size_t taken;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			taken = std::min(count, resources.size());
+			std::copy(resources.end() - taken, resources.end(), objects);
+			resources.resize(resources.size() - taken);
+		}
+
+		for (std::size_t i = taken; i < count; i++)
+			objects[i] = new Resource();
+	}
+	// Resets objects[0..count) and returns them to the pool
+	void releaseBulk(Resource* const* objects, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			objects[i]->reset();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		resources.insert(resources.end(), objects, objects + count);
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()
+	{
+		for (auto object : resources)
+			delete object;
+	}
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::mutex mutex;
+	std::vector<Resource*> resources;
+};
+
+#pragma region Benchmark
+
+// Nanoseconds per object when a batch of the given size
+// is taken and returned one by one or with bulk calls
+template<class Cycle>
+double measure(std::size_t batch, Cycle cycle)
+{
+	const std::size_t objects = 4000000;
+	std::vector<Resource*> held(batch);
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t done = 0; done < objects; done += batch)
+		cycle(held.data(), batch);
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / objects;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	Resource* batch[3];
+	pool.acquireBulk(batch, 3);
+	for (int i = 0; i < 3; i++)
+	{
+		batch[i]->setValue(i + 1);
+		std::cout << "batch[" << i << "] = " << batch[i]->getValue() << " [" << batch[i] << "]" << std::endl;
+	}
+	pool.releaseBulk(batch, 3);
+
+	pool.acquireBulk(batch, 3);
+	for (int i = 0; i < 3; i++)
+		std::cout << "batch[" << i << "] = " << batch[i]->getValue() << " [" << batch[i] << "]" << std::endl;
+	pool.releaseBulk(batch, 3);
+	// ...
+
+	std::cout << std::endl << "Nanoseconds per object:" << std::endl;
+	std::cout << "batch\tsingle\tbulk" << std::endl;
+
+	for (std::size_t size = 1; size <= 1024; size *= 4)
+	{
+		double single = measure(size, [&pool](Resource** objects, std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; i++)
+				objects[i] = pool.getResource();
+			for (std::size_t i = 0; i < count; i++)
+				pool.releaseResource(objects[i]);
+		});
+		double bulk = measure(size, [&pool](Resource** objects, std::size_t count)
+		{
+			pool.acquireBulk(objects, count);
+			pool.releaseBulk(objects, count);
+		});
+
+		std::cout << size << "\t" << single << "\t" << bulk << std::endl;
+	}
+
+	return 0;
+}
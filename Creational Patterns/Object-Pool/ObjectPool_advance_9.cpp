@@ -0,0 +1,179 @@
+/*
+ * C++ Design Patterns: Object Pool
+ *
+ * The use of the Object Pool pattern can significantly improve system performance;
+ * its use is most effective in situations where creating instances of a certain class is
+ * expensive, objects in the system are created often, but the number of objects created
+ * in a unit of time is limited.
+ *
+ * In this variant clients hold 32-bit handles instead of pointers. A handle stores the
+ * index of the object in a dense array and the generation of that slot; each release
+ * bumps the generation, so a handle kept after release is recognized as stale. A slot
+ * whose generation has run out is retired rather than reused, so a generation never wraps.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<cstdint>
+#include<cstddef>
+#include<stdexcept>
+
+/*
+ * ### When to use ###
+ *
+ * Used to control the caching of objects. A client that has access to an object pool can
+ * avoid creating new objects by simply querying the already created instance in the pool.
+ * Handles are used when many structures refer to pooled objects, references must be
+ * compact, and a reference to an object already given back must not reach its new owner.
+ *
+ */
+
+// Reusable object
+class Resource
+{
+public:
+	Resource() : number(0) {}
+
+	void reset()
+	{
+		this->number = 0;
+	}
+	int getValue()
+	{
+		return this->number;
+	}
+	void setValue(int number)
+	{
+		this->number = number;
+	}
+	// ...
+
+private:
+	int number;
+};
+
+// 20 bits of index and 12 bits of generation. Generation 0 is never
+// given out, so a zero handle refers to nothing and a retired slot matches no handle
+class ResourceHandle
+{
+public:
+	static const uint32_t indexBits = 20;
+	static const uint32_t indexMask = (1u << indexBits) - 1;
+	static const uint32_t generationMask = (1u << (32 - indexBits)) - 1;
+
+	ResourceHandle() : value(0) {}
+	ResourceHandle(uint32_t index, uint32_t generation)
+		: value((generation << indexBits) | index) {}
+
+	uint32_t index() const		{ return value & indexMask; }
+	uint32_t generation() const	{ return value >> indexBits; }
+	bool isNull() const			{ return value == 0; }
+
+private:
+	uint32_t value;
+};
+
+// Reusable Pool
+class ObjectPool
+{
+public:
+	static ObjectPool& getInstance()
+	{
+		static ObjectPool instance;
+		return instance;
+	}
+	ResourceHandle acquire()
+	{
+		uint32_t index;
+		if (!freeSlots.empty())
+		{
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			if (objects.size() > ResourceHandle::indexMask)
+				throw std::length_error("ObjectPool: no more handle indices");
+
+			index = uint32_t(objects.size());
+			objects.emplace_back();
+			generations.push_back(1);
+		}
+		return ResourceHandle(index, generations[index]);
+	}
+	void release(ResourceHandle handle)
+	{
+		Resource* object = get(handle);
+		if (object == nullptr)
+			return;
+
+		object->reset();
+
+		// After the last generation the slot is retired: reusing it from
+		// generation 1 would bring the handles of its first owners back to life
+		uint32_t& generation = generations[handle.index()];
+		if (generation == ResourceHandle::generationMask)
+		{
+			generation = 0;
+			return;
+		}
+
+		generation++;
+		freeSlots.push_back(handle.index());
+	}
+	// Returns nullptr for a stale or null handle. The pointer is valid
+	// until the next acquire(), which may grow the array
+	Resource* get(ResourceHandle handle)
+	{
+		uint32_t index = handle.index();
+		if (handle.isNull() || index >= objects.size() || generations[index] != handle.generation())
+			return nullptr;
+		return &objects[index];
+	}
+
+protected:
+	ObjectPool()							= default;
+	~ObjectPool()							= default;
+	ObjectPool(const ObjectPool&)			= delete;
+	ObjectPool& operator = (ObjectPool&)	= delete;
+
+private:
+	std::vector<Resource> objects;		// all objects, side by side
+	std::vector<uint32_t> generations;	// current generation of every slot
+	std::vector<uint32_t> freeSlots;
+};
+
+
+int main()
+{
+	ObjectPool& pool = ObjectPool::getInstance();
+
+	ResourceHandle one = pool.acquire();
+	pool.get(one)->setValue(10);
+	std::cout << "one = " << pool.get(one)->getValue()
+		<< " [index " << one.index() << ", generation " << one.generation() << "]" << std::endl;
+
+	pool.release(one);
+
+	ResourceHandle two = pool.acquire();
+	pool.get(two)->setValue(20);
+	std::cout << "two = " << pool.get(two)->getValue()
+		<< " [index " << two.index() << ", generation " << two.generation() << "]" << std::endl;
+
+	// The slot is reused, but the old handle no longer reaches it
+	std::cout << "one is " << (pool.get(one) == nullptr ? "stale" : "alive") << std::endl;
+	pool.release(two);
+	// ...
+
+	std::cout << std::endl;
+	std::cout << "size of a handle:  " << sizeof(ResourceHandle) << " bytes" << std::endl;
+	std::cout << "size of a pointer: " << sizeof(Resource*) << " bytes" << std::endl;
+
+	const std::size_t references = 1000000;
+	std::cout << "table of " << references << " references: "
+		<< references * sizeof(ResourceHandle) / 1024 << " KB instead of "
+		<< references * sizeof(Resource*) / 1024 << " KB" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,229 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * In this variant the registry of prototypes is a plain array indexed by Entity_ID.
+ * Its size is taken from the enum at compile time, and finding a prototype is one
+ * bounds check and one load instead of two searches in a std::map.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<map>
+#include<chrono>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+class Unit;
+typedef std::array<Unit*, std::size_t(Entity_ID::Count)> Registry;
+
+// The registry of prototypes is defined as Singleton
+Registry& getRegistry()
+{
+	static Registry _instance{};
+	return _instance;
+}
+
+// The only purpose of this class is to help in choosing
+// the right constructor when creating prototypes
+class Dummy { /* ... */ };
+
+// Polymorphic base class. It also defines a static
+// generalized constructor for creating units
+class Unit
+{
+public:
+	virtual Unit* clone()	= 0;
+	virtual void info()		= 0;
+	virtual ~Unit()			= default;
+
+	static Unit* create(Entity_ID id)
+	{
+		Registry& reg = getRegistry();
+		std::size_t index = std::size_t(id);
+
+		if (index < reg.size() && reg[index] != nullptr)
+			return reg[index]->clone();
+		return nullptr;
+	}
+	// ...
+
+protected:
+	static void addPrototype(Entity_ID id, Unit* prototype)
+	{
+		getRegistry()[std::size_t(id)] = prototype;
+	}
+	static void removePrototype(Entity_ID id)
+	{
+		getRegistry()[std::size_t(id)] = nullptr;
+	}
+};
+
+// In the derived classes of different combat units in the form of static
+// data members, the corresponding prototypes are determined
+#pragma region Units
+
+class Tank : public Unit
+{
+private:
+	Tank() = default;
+	Tank(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Tank_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Tank(*this);
+	}
+	void info() override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Tank prototype;
+};
+
+class Plain : public Unit
+{
+private:
+	Plain() = default;
+	Plain(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Plain_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Plain(*this);
+	}
+	void info() override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Plain prototype;
+};
+
+class Solder : public Unit
+{
+private:
+	Solder() = default;
+	Solder(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Solder_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Solder(*this);
+	}
+	void info() override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	static Solder prototype;
+};
+
+Tank	Tank::prototype		= Tank	(Dummy());
+Plain	Plain::prototype	= Plain	(Dummy());
+Solder	Solder::prototype	= Solder(Dummy());
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// The registry of Prototype_advance_1.cpp, filled with the same prototypes
+std::map<Entity_ID, Unit*>& getMapRegistry()
+{
+	static std::map<Entity_ID, Unit*> _instance;
+	return _instance;
+}
+
+Unit* createFromMap(Entity_ID id)
+{
+	std::map<Entity_ID, Unit*>& reg = getMapRegistry();
+
+	if (reg.find(id) != reg.end())
+		return reg[id]->clone();
+	return nullptr;
+}
+
+// Units spawned (cloned and destroyed) per second, for a mix of all types
+template<class Create>
+double measure(Create create)
+{
+	const int spawns = 3000000;
+	const std::size_t types = std::size_t(Entity_ID::Count);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < spawns; i++)
+		delete create(Entity_ID(i % types));
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return spawns / elapsed.count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	std::vector<Unit*> vec;
+	vec.push_back(Unit::create(Entity_ID::Tank_ID));
+	vec.push_back(Unit::create(Entity_ID::Plain_ID));
+	vec.push_back(Unit::create(Entity_ID::Solder_ID));
+
+	for (auto& object : vec)
+		object->info();
+	// ...
+
+	for (std::size_t i = 0; i < std::size_t(Entity_ID::Count); i++)
+		getMapRegistry()[Entity_ID(i)] = getRegistry()[i];
+
+	std::cout << std::endl << "Units spawned per second, millions:" << std::endl;
+	std::cout << "std::map: " << measure(createFromMap) / 1e6 << std::endl;
+	std::cout << "array:    " << measure(Unit::create) / 1e6 << std::endl;
+
+	for (auto& object : vec)
+		delete object;
+
+	return 0;
+}
@@ -0,0 +1,366 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * This variant clones in batches. One virtual call copies the prototype N times
+ * into a single block of memory, and the result is a range over units which lie
+ * back to back, instead of N separate allocations spread across the heap.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<chrono>
+#include<new>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+class Unit;
+class UnitBatch;
+typedef std::array<Unit*, std::size_t(Entity_ID::Count)> Registry;
+
+// The registry of prototypes is defined as Singleton
+Registry& getRegistry()
+{
+	static Registry _instance{};
+	return _instance;
+}
+
+// The only purpose of this class is to help in choosing
+// the right constructor when creating prototypes
+class Dummy { /* ... */ };
+
+// Polymorphic base class. It also defines static
+// generalized constructors for creating units
+class Unit
+{
+public:
+	virtual Unit* clone()						= 0;
+	virtual UnitBatch cloneBatch(std::size_t n)	= 0;
+	virtual void info()							= 0;
+	virtual int power()							= 0;
+	virtual ~Unit()								= default;
+
+	static Unit* create(Entity_ID id);
+	static UnitBatch cloneN(Entity_ID id, std::size_t n);
+	// ...
+
+protected:
+	static void addPrototype(Entity_ID id, Unit* prototype)
+	{
+		getRegistry()[std::size_t(id)] = prototype;
+	}
+	// Copies the prototype n times into one block
+	template<class T>
+	static UnitBatch cloneInto(const T& prototype, std::size_t n);
+
+	int health = 100;
+};
+
+// N units of one type placed back to back in a single block, which it owns
+class UnitBatch
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator(char* position, std::size_t stride) : position(position), stride(stride) {}
+
+		Unit& operator*() const						{ return *reinterpret_cast<Unit*>(position); }
+		Iterator& operator++()						{ position += stride; return *this; }
+		bool operator!=(const Iterator& other) const	{ return position != other.position; }
+
+	private:
+		char* position;
+		std::size_t stride;
+	};
+
+	UnitBatch() : block(nullptr), first(nullptr), count(0), stride(0) {}
+	UnitBatch(void* block, Unit* first, std::size_t count, std::size_t stride)
+		: block(block), first(reinterpret_cast<char*>(first)), count(count), stride(stride) {}
+	UnitBatch(UnitBatch&& other) noexcept
+		: block(other.block), first(other.first), count(other.count), stride(other.stride)
+	{
+		other.block = nullptr;
+		other.count = 0;
+	}
+	// Destroys the units held now before taking over the other batch
+	UnitBatch& operator = (UnitBatch&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			block = other.block;
+			first = other.first;
+			count = other.count;
+			stride = other.stride;
+			other.block = nullptr;
+			other.count = 0;
+		}
+		return *this;
+	}
+	UnitBatch(const UnitBatch&)					= delete;
+	UnitBatch& operator = (const UnitBatch&)	= delete;
+	~UnitBatch()
+	{
+		release();
+	}
+
+	Unit& operator[](std::size_t i) const	{ return *reinterpret_cast<Unit*>(first + i * stride); }
+	std::size_t size() const				{ return count; }
+	Iterator begin() const					{ return Iterator(first, stride); }
+	Iterator end() const					{ return Iterator(first + count * stride, stride); }
+
+private:
+	void release()
+	{
+		for (auto& unit : *this)
+			unit.~Unit();
+		::operator delete(block);
+	}
+
+	void* block;
+	char* first;			// the Unit part of the first unit
+	std::size_t count;
+	std::size_t stride;		// size of the concrete unit type
+};
+
+Unit* Unit::create(Entity_ID id)
+{
+	Registry& reg = getRegistry();
+	std::size_t index = std::size_t(id);
+
+	if (index < reg.size() && reg[index] != nullptr)
+		return reg[index]->clone();
+	return nullptr;
+}
+
+UnitBatch Unit::cloneN(Entity_ID id, std::size_t n)
+{
+	Registry& reg = getRegistry();
+	std::size_t index = std::size_t(id);
+
+	if (index < reg.size() && reg[index] != nullptr)
+		return reg[index]->cloneBatch(n);
+	return UnitBatch();
+}
+
+template<class T>
+UnitBatch Unit::cloneInto(const T& prototype, std::size_t n)
+{
+	void* block = ::operator new(n * sizeof(T));
+	T* units = static_cast<T*>(block);
+
+	std::size_t built = 0;
+	try
+	{
+		for (; built < n; built++)
+			::new (static_cast<void*>(units + built)) T(prototype);
+	}
+	catch (...)
+	{
+		while (built > 0)
+			units[--built].~T();
+		::operator delete(block);
+		throw;
+	}
+
+	return UnitBatch(block, static_cast<Unit*>(units), n, sizeof(T));
+}
+
+// In the derived classes of different combat units in the form of static
+// data members, the corresponding prototypes are determined
+#pragma region Units
+
+class Tank : public Unit
+{
+private:
+	Tank() = default;
+	Tank(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Tank_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Tank(*this);
+	}
+	UnitBatch cloneBatch(std::size_t n) override
+	{
+		return Unit::cloneInto(*this, n);
+	}
+	void info() override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health * armor;
+	}
+	// ...
+
+private:
+	int armor = 5;
+	static Tank prototype;
+};
+
+class Plain : public Unit
+{
+private:
+	Plain() = default;
+	Plain(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Plain_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Plain(*this);
+	}
+	UnitBatch cloneBatch(std::size_t n) override
+	{
+		return Unit::cloneInto(*this, n);
+	}
+	void info() override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health + speed;
+	}
+	// ...
+
+private:
+	int speed = 900;
+	static Plain prototype;
+};
+
+class Solder : public Unit
+{
+private:
+	Solder() = default;
+	Solder(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Solder_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Solder(*this);
+	}
+	UnitBatch cloneBatch(std::size_t n) override
+	{
+		return Unit::cloneInto(*this, n);
+	}
+	void info() override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	int power() override
+	{
+		return health;
+	}
+	// ...
+
+private:
+	static Solder prototype;
+};
+
+Tank	Tank::prototype		= Tank	(Dummy());
+Plain	Plain::prototype	= Plain	(Dummy());
+Solder	Solder::prototype	= Solder(Dummy());
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	UnitBatch wave = Unit::cloneN(Entity_ID::Solder_ID, 3);
+	for (auto& object : wave)
+		object.info();
+	// ...
+
+	const std::size_t n = 1000000;
+	const int passes = 10;
+
+	std::cout << std::endl << n << " tanks, ms:" << std::endl;
+
+	// One clone() and one allocation per unit
+	auto start = std::chrono::steady_clock::now();
+	std::vector<Unit*> units;
+	units.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+		units.push_back(Unit::create(Entity_ID::Tank_ID));
+	double spawnSingle = elapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for (int pass = 0; pass < passes; pass++)
+		for (auto object : units)
+			sum += object->power();
+	double iterateSingle = elapsedMilliseconds(start) / passes;
+
+	// One cloneBatch() and one allocation for all units
+	start = std::chrono::steady_clock::now();
+	UnitBatch batch = Unit::cloneN(Entity_ID::Tank_ID, n);
+	double spawnBatch = elapsedMilliseconds(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < passes; pass++)
+		for (auto& object : batch)
+			sum += object.power();
+	double iterateBatch = elapsedMilliseconds(start) / passes;
+	sink = sum;
+
+	std::cout << "\t\tspawn\titerate" << std::endl;
+	std::cout << "clone()\t\t" << spawnSingle << "\t" << iterateSingle << std::endl;
+	std::cout << "cloneN()\t" << spawnBatch << "\t" << iterateBatch << std::endl;
+
+	for (auto object : units)
+		delete object;
+
+	return 0;
+}
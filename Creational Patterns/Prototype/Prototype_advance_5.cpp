@@ -0,0 +1,329 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * In this variant clone() takes a std::pmr::memory_resource, so clones can be built
+ * in an arena. A population created for one frame is placed in a monotonic buffer,
+ * and the whole buffer is released at once at the end of the frame.
+ *
+ */
+
+#include<iostream>
+#include<iomanip>
+#include<vector>
+#include<array>
+#include<memory_resource>
+#include<chrono>
+#include<random>
+#include<algorithm>
+#include<cstdint>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+class Unit;
+typedef std::array<Unit*, std::size_t(Entity_ID::Count)> Registry;
+
+// The registry of prototypes is defined as Singleton
+Registry& getRegistry()
+{
+	static Registry _instance{};
+	return _instance;
+}
+
+// The only purpose of this class is to help in choosing
+// the right constructor when creating prototypes
+class Dummy { /* ... */ };
+
+// Polymorphic base class. It also defines a static
+// generalized constructor for creating units
+class Unit
+{
+public:
+	virtual Unit* clone(std::pmr::memory_resource& resource)	= 0;
+	virtual void info()											= 0;
+	virtual ~Unit()												= default;
+
+	// Clones from the heap when no resource is given
+	static Unit* create(Entity_ID id, std::pmr::memory_resource& resource = *std::pmr::new_delete_resource())
+	{
+		Registry& reg = getRegistry();
+		std::size_t index = std::size_t(id);
+
+		if (index < reg.size() && reg[index] != nullptr)
+			return reg[index]->clone(resource);
+		return nullptr;
+	}
+	// Destroys a unit and gives its memory back to the resource it came from
+	static void destroy(Unit* unit, std::pmr::memory_resource& resource = *std::pmr::new_delete_resource())
+	{
+		unit->dispose(resource);
+	}
+	// ...
+
+protected:
+	virtual void dispose(std::pmr::memory_resource& resource) = 0;
+
+	static void addPrototype(Entity_ID id, Unit* prototype)
+	{
+		getRegistry()[std::size_t(id)] = prototype;
+	}
+	template<class T>
+	static T* cloneWith(const T& prototype, std::pmr::memory_resource& resource)
+	{
+		void* memory = resource.allocate(sizeof(T), alignof(T));
+		try
+		{
+			return ::new (memory) T(prototype);
+		}
+		catch (...)
+		{
+			resource.deallocate(memory, sizeof(T), alignof(T));
+			throw;
+		}
+	}
+	template<class T>
+	static void disposeWith(T* unit, std::pmr::memory_resource& resource)
+	{
+		unit->~T();
+		resource.deallocate(unit, sizeof(T), alignof(T));
+	}
+};
+
+// In the derived classes of different combat units in the form of static
+// data members, the corresponding prototypes are determined
+#pragma region Units
+
+class Tank : public Unit
+{
+private:
+	Tank() = default;
+	Tank(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Tank_ID, this);
+	}
+
+public:
+	Unit* clone(std::pmr::memory_resource& resource) override
+	{
+		return Unit::cloneWith(*this, resource);
+	}
+	void info() override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+protected:
+	void dispose(std::pmr::memory_resource& resource) override
+	{
+		Unit::disposeWith(this, resource);
+	}
+
+private:
+	int armor[16] = {};
+	static Tank prototype;
+};
+
+class Plain : public Unit
+{
+private:
+	Plain() = default;
+	Plain(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Plain_ID, this);
+	}
+
+public:
+	Unit* clone(std::pmr::memory_resource& resource) override
+	{
+		return Unit::cloneWith(*this, resource);
+	}
+	void info() override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+protected:
+	void dispose(std::pmr::memory_resource& resource) override
+	{
+		Unit::disposeWith(this, resource);
+	}
+
+private:
+	double route[8] = {};
+	static Plain prototype;
+};
+
+class Solder : public Unit
+{
+private:
+	Solder() = default;
+	Solder(Dummy)
+	{
+		Unit::addPrototype(Entity_ID::Solder_ID, this);
+	}
+
+public:
+	Unit* clone(std::pmr::memory_resource& resource) override
+	{
+		return Unit::cloneWith(*this, resource);
+	}
+	void info() override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+protected:
+	void dispose(std::pmr::memory_resource& resource) override
+	{
+		Unit::disposeWith(this, resource);
+	}
+
+private:
+	int ammo = 30;
+	static Solder prototype;
+};
+
+Tank	Tank::prototype		= Tank	(Dummy());
+Plain	Plain::prototype	= Plain	(Dummy());
+Solder	Solder::prototype	= Solder(Dummy());
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// Spawn/despawn workload: every frame spawns a population of random units,
+// despawns a random half of them during the frame and the rest at its end.
+// Prints the time per frame and the spread of the last frame's units
+template<class Frame>
+void measure(const char* name, Frame frame)
+{
+	const int frames = 200;
+	const std::size_t population = 20000;
+	std::mt19937 random(7);
+	std::vector<Unit*> units;
+	units.reserve(population);
+	double spread = 0.0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int f = 0; f < frames; f++)
+	{
+		spread = frame(units, random, population);
+		units.clear();
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << std::left << std::setw(20) << name << elapsed.count() / frames << " ms/frame\tspread " << spread << std::endl;
+}
+
+// Address range of the units divided by their total size (1.0 means no gaps at all)
+double spreadOf(const std::vector<Unit*>& units, std::size_t bytes)
+{
+	auto range = std::minmax_element(units.begin(), units.end(),
+		[](Unit* a, Unit* b) { return std::uintptr_t(a) < std::uintptr_t(b); });
+	return double(std::uintptr_t(*range.second) - std::uintptr_t(*range.first)) / double(bytes);
+}
+
+// Clones the population and despawns half of it; returns the spread after spawning
+double spawn(std::vector<Unit*>& units, std::mt19937& random, std::size_t population,
+	std::pmr::memory_resource& resource)
+{
+	std::size_t bytes = 0;
+	for (std::size_t i = 0; i < population; i++)
+	{
+		Entity_ID id = Entity_ID(random() % std::size_t(Entity_ID::Count));
+		units.push_back(Unit::create(id, resource));
+		bytes += id == Entity_ID::Tank_ID ? sizeof(Tank) : id == Entity_ID::Plain_ID ? sizeof(Plain) : sizeof(Solder);
+	}
+	double spread = spreadOf(units, bytes);
+
+	std::shuffle(units.begin(), units.end(), random);
+	for (std::size_t i = 0; i < population / 2; i++)
+		Unit::destroy(units[i], resource);
+	units.erase(units.begin(), units.begin() + population / 2);
+
+	return spread;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	std::pmr::monotonic_buffer_resource arena;
+
+	std::vector<Unit*> vec;
+	vec.push_back(Unit::create(Entity_ID::Tank_ID, arena));
+	vec.push_back(Unit::create(Entity_ID::Plain_ID, arena));
+	vec.push_back(Unit::create(Entity_ID::Solder_ID, arena));
+
+	for (auto& object : vec)
+		object->info();
+	// ...
+
+	// The units have trivial members, but their destructors still run;
+	// only the memory is released in one step
+	for (auto& object : vec)
+		Unit::destroy(object, arena);
+	arena.release();
+
+	std::cout << std::endl;
+
+	measure("new/delete", [](std::vector<Unit*>& units, std::mt19937& random, std::size_t population)
+	{
+		std::pmr::memory_resource& heap = *std::pmr::new_delete_resource();
+		double spread = spawn(units, random, population, heap);
+		for (auto unit : units)
+			Unit::destroy(unit, heap);
+		return spread;
+	});
+
+	// Every frame builds a new arena over the same external buffer, so no memory
+	// is requested from the heap unless a frame outgrows the buffer
+	std::vector<std::byte> buffer(4 << 20);
+	measure("arena, destroy each", [&buffer](std::vector<Unit*>& units, std::mt19937& random, std::size_t population)
+	{
+		std::pmr::monotonic_buffer_resource frameArena(buffer.data(), buffer.size());
+		double spread = spawn(units, random, population, frameArena);
+		for (auto unit : units)
+			Unit::destroy(unit, frameArena);
+		return spread;
+	});
+
+	// The units own no resources, so their destructors do nothing and may be skipped:
+	// the survivors are dropped at the end of the frame together with the arena
+	measure("arena, release", [&buffer](std::vector<Unit*>& units, std::mt19937& random, std::size_t population)
+	{
+		std::pmr::monotonic_buffer_resource frameArena(buffer.data(), buffer.size());
+		return spawn(units, random, population, frameArena);
+	});
+
+	return 0;
+}
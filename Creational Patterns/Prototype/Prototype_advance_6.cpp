@@ -0,0 +1,285 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * In this variant the large intrinsic data of a unit (stats, mesh, name) is copied
+ * on write. A clone shares the prototype's block through a reference count and gets
+ * its own copy only when it changes that data for the first time.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<string>
+#include<memory>
+#include<chrono>
+#include<cstdlib>
+#include<cstddef>
+#include<new>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Counts the bytes requested from the global allocator to show the memory taken by clones
+static std::size_t allocatedBytes = 0;
+
+void* operator new(std::size_t size)
+{
+	allocatedBytes += size;
+	if (void* p = std::malloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+// Pointer to data shared between copies. Reading never copies; the first
+// write through a copy which still shares the data gives it its own copy.
+// The reference count is thread-safe, but a unit itself is not
+template<class T>
+class CopyOnWrite
+{
+public:
+	explicit CopyOnWrite(T value) : data(std::make_shared<T>(std::move(value))) {}
+
+	const T& read() const
+	{
+		return *data;
+	}
+	T& write()
+	{
+		if (data.use_count() > 1)
+			data = std::make_shared<T>(*data);
+		return *data;
+	}
+	bool shared() const
+	{
+		return data.use_count() > 1;
+	}
+
+private:
+	std::shared_ptr<T> data;
+};
+
+// Intrinsic data of a unit type, large and rarely changed
+struct UnitData
+{
+	std::string name;
+	std::vector<int> stats;
+	std::vector<float> mesh;
+};
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+class Unit;
+typedef std::array<Unit*, std::size_t(Entity_ID::Count)> Registry;
+
+// The registry of prototypes is defined as Singleton
+Registry& getRegistry()
+{
+	static Registry _instance{};
+	return _instance;
+}
+
+// The only purpose of this class is to help in choosing
+// the right constructor when creating prototypes
+class Dummy { /* ... */ };
+
+// Polymorphic base class. It also defines a static
+// generalized constructor for creating units
+class Unit
+{
+public:
+	virtual Unit* clone()	= 0;
+	virtual ~Unit()			= default;
+
+	void info()
+	{
+		std::cout << data.read().name
+			<< (data.shared() ? " (shared data)" : " (own data)") << std::endl;
+	}
+	void upgrade(int stat, int value)
+	{
+		data.write().stats[stat] = value;
+	}
+
+	static Unit* create(Entity_ID id)
+	{
+		Registry& reg = getRegistry();
+		std::size_t index = std::size_t(id);
+
+		if (index < reg.size() && reg[index] != nullptr)
+			return reg[index]->clone();
+		return nullptr;
+	}
+	// ...
+
+protected:
+	explicit Unit(UnitData data) : data(std::move(data)) {}
+
+	static void addPrototype(Entity_ID id, Unit* prototype)
+	{
+		getRegistry()[std::size_t(id)] = prototype;
+	}
+
+	CopyOnWrite<UnitData> data;
+	int health = 100;
+};
+
+// In the derived classes of different combat units in the form of static
+// data members, the corresponding prototypes are determined
+#pragma region Units
+
+class Tank : public Unit
+{
+private:
+	Tank(Dummy) : Unit(UnitData{ "Tank", std::vector<int>(256, 5), std::vector<float>(4096, 1.0f) })
+	{
+		Unit::addPrototype(Entity_ID::Tank_ID, this);
+	}
+
+public:
+	// Copying a unit copies the shared pointer, not the data behind it
+	Unit* clone() override
+	{
+		return new Tank(*this);
+	}
+	// ...
+
+private:
+	static Tank prototype;
+};
+
+class Plain : public Unit
+{
+private:
+	Plain(Dummy) : Unit(UnitData{ "Plain", std::vector<int>(256, 3), std::vector<float>(8192, 2.0f) })
+	{
+		Unit::addPrototype(Entity_ID::Plain_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Plain(*this);
+	}
+	// ...
+
+private:
+	static Plain prototype;
+};
+
+class Solder : public Unit
+{
+private:
+	Solder(Dummy) : Unit(UnitData{ "Solder", std::vector<int>(256, 1), std::vector<float>(1024, 0.5f) })
+	{
+		Unit::addPrototype(Entity_ID::Solder_ID, this);
+	}
+
+public:
+	Unit* clone() override
+	{
+		return new Solder(*this);
+	}
+	// ...
+
+private:
+	static Solder prototype;
+};
+
+Tank	Tank::prototype		= Tank	(Dummy());
+Plain	Plain::prototype	= Plain	(Dummy());
+Solder	Solder::prototype	= Solder(Dummy());
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// The same tank with its data held by value, as in Prototype_advance_1.cpp
+class DeepTank
+{
+public:
+	DeepTank() : data{ "Tank", std::vector<int>(256, 5), std::vector<float>(4096, 1.0f) } {}
+	DeepTank* clone()
+	{
+		return new DeepTank(*this);
+	}
+
+private:
+	UnitData data;
+	int health = 100;
+};
+
+// Every clone is destroyed right away, so that a million deep copies fit in memory;
+// the bytes requested per clone are what each of them would occupy if kept alive
+template<class Clone>
+void measure(const char* name, std::size_t n, Clone clone)
+{
+	std::size_t before = allocatedBytes;
+	auto start = std::chrono::steady_clock::now();
+	clone(n);
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << name << "\t" << elapsed.count() / n << " ns/clone\t"
+		<< (allocatedBytes - before) / n << " bytes/clone" << std::endl;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	Unit* first = Unit::create(Entity_ID::Tank_ID);
+	Unit* second = Unit::create(Entity_ID::Tank_ID);
+	first->info();
+
+	second->upgrade(0, 10);
+	second->info();
+	// ...
+
+	delete first;
+	delete second;
+
+	const std::size_t n = 1000000;
+	std::cout << std::endl << n << " tank clones:" << std::endl;
+
+	measure("deep copy", n, [](std::size_t count)
+	{
+		DeepTank prototype;
+		for (std::size_t i = 0; i < count; i++)
+			delete prototype.clone();
+	});
+	measure("copy on write", n, [](std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			delete Unit::create(Entity_ID::Tank_ID);
+	});
+
+	return 0;
+}
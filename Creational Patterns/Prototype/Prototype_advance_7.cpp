@@ -0,0 +1,406 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * In this variant the registry of prototypes can be changed while other threads
+ * clone from it. The registry is an immutable version behind an atomic pointer
+ * (read-copy-update): a writer copies the current version, changes the copy and
+ * publishes it; readers never wait. An old version is deleted only after every
+ * reader which could still see it has left its read section (epoch-based reclamation).
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<memory>
+#include<atomic>
+#include<mutex>
+#include<shared_mutex>
+#include<map>
+#include<thread>
+#include<chrono>
+#include<algorithm>
+#include<stdexcept>
+#include<cstdint>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+// Polymorphic base class
+class Unit
+{
+public:
+	virtual Unit* clone() const	= 0;
+	virtual void info()			= 0;
+	virtual ~Unit()				= default;
+	// ...
+};
+
+// Registry of prototypes shared by many cloning threads and a few writers
+class PrototypeRegistry
+{
+public:
+	static PrototypeRegistry& getInstance()
+	{
+		static PrototypeRegistry instance;
+		return instance;
+	}
+
+	// Readers at once, each thread holds one slot while it lives
+	static constexpr std::size_t maxReaders = 128;
+
+	// Never waits for writers. Only the first call of a thread takes a lock, to get
+	// a reader slot, and throws if maxReaders threads already hold one
+	Unit* create(Entity_ID id)
+	{
+		std::size_t index = std::size_t(id);
+		if (index >= std::size_t(Entity_ID::Count))
+			return nullptr;
+
+		ReadSection section(readerSlot());
+		const Version* version = current.load(std::memory_order_seq_cst);
+		const Unit* prototype = version->prototypes[index].get();
+
+		return prototype != nullptr ? prototype->clone() : nullptr;
+	}
+
+	// Publishes a new version with one prototype replaced
+	void addPrototype(Entity_ID id, std::shared_ptr<const Unit> prototype)
+	{
+		std::lock_guard<std::mutex> lock(writer);
+
+		Version* next = new Version(*current.load(std::memory_order_relaxed));
+		next->prototypes[std::size_t(id)] = std::move(prototype);
+
+		Version* old = current.exchange(next, std::memory_order_seq_cst);
+		uint64_t retiredAt = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+		retired.push_back(Retired{ old, retiredAt });
+
+		reclaim();
+	}
+	void removePrototype(Entity_ID id)
+	{
+		addPrototype(id, nullptr);
+	}
+
+protected:
+	PrototypeRegistry() : current(new Version()), epoch(1), readerCount(0)
+	{
+		freeSlots.reserve(maxReaders);
+	}
+	~PrototypeRegistry()
+	{
+		for (auto& r : retired)
+			delete r.version;
+		delete current.load();
+	}
+	PrototypeRegistry(const PrototypeRegistry&)				= delete;
+	PrototypeRegistry& operator = (PrototypeRegistry&)		= delete;
+
+private:
+	// Prototypes are shared between versions; a version is never changed once published
+	struct Version
+	{
+		std::array<std::shared_ptr<const Unit>, std::size_t(Entity_ID::Count)> prototypes;
+	};
+	struct Retired
+	{
+		Version* version;
+		uint64_t epoch;
+	};
+	// Epoch observed by a reader inside its read section, 0 outside of it.
+	// Every slot has its own cache line, so readers do not disturb each other
+	struct alignas(64) ReaderSlot
+	{
+		std::atomic<uint64_t> epoch{ 0 };
+	};
+
+	class ReadSection
+	{
+	public:
+		explicit ReadSection(ReaderSlot& slot) : slot(slot)
+		{
+			PrototypeRegistry& registry = PrototypeRegistry::getInstance();
+			slot.epoch.store(registry.epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		}
+		~ReadSection()
+		{
+			slot.epoch.store(0, std::memory_order_release);
+		}
+
+	private:
+		ReaderSlot& slot;
+	};
+
+	// Gives the slot of a thread back when the thread exits
+	class SlotLease
+	{
+	public:
+		SlotLease() : slot(nullptr) {}
+		~SlotLease()
+		{
+			if (slot != nullptr)
+				PrototypeRegistry::getInstance().releaseSlot(slot);
+		}
+
+		ReaderSlot* slot;
+	};
+
+	ReaderSlot& readerSlot()
+	{
+		thread_local SlotLease lease;
+		if (lease.slot == nullptr)
+			lease.slot = acquireSlot();
+		return *lease.slot;
+	}
+
+	// readerCount is the number of slots ever used; reclaim() looks at all of them
+	ReaderSlot* acquireSlot()
+	{
+		std::lock_guard<std::mutex> lock(slotLock);
+		std::size_t index;
+		if (!freeSlots.empty())
+		{
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			index = readerCount.load(std::memory_order_relaxed);
+			if (index == maxReaders)
+				throw std::runtime_error("PrototypeRegistry: too many reader threads at once");
+			readerCount.store(index + 1, std::memory_order_seq_cst);
+		}
+		return &readers[index];
+	}
+	// Does not allocate: freeSlots has room for every slot
+	void releaseSlot(ReaderSlot* slot)
+	{
+		std::lock_guard<std::mutex> lock(slotLock);
+		freeSlots.push_back(std::size_t(slot - readers));
+	}
+
+	// A version retired at epoch E may still be read only by a reader
+	// which entered its section with an epoch smaller than E
+	void reclaim()
+	{
+		uint64_t oldest = UINT64_MAX;
+		std::size_t count = readerCount.load(std::memory_order_seq_cst);
+		for (std::size_t i = 0; i < count; i++)
+		{
+			uint64_t e = readers[i].epoch.load(std::memory_order_seq_cst);
+			if (e != 0 && e < oldest)
+				oldest = e;
+		}
+
+		std::size_t kept = 0;
+		for (auto& r : retired)
+		{
+			if (r.epoch <= oldest)
+				delete r.version;
+			else
+				retired[kept++] = r;
+		}
+		retired.resize(kept);
+	}
+
+	std::atomic<Version*> current;
+	std::atomic<uint64_t> epoch;
+	std::atomic<std::size_t> readerCount;
+	ReaderSlot readers[maxReaders];
+	std::mutex slotLock;
+	std::vector<std::size_t> freeSlots;
+
+	std::mutex writer;
+	std::vector<Retired> retired;
+};
+
+// Derived classes of various combat units. The stats change with balance patches
+#pragma region Units
+
+class Tank : public Unit
+{
+public:
+	explicit Tank(int armor) : armor(armor) {}
+
+	Unit* clone() const override
+	{
+		return new Tank(*this);
+	}
+	void info() override
+	{
+		std::cout << "Tank, armor " << armor << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int armor;
+};
+
+class Plain : public Unit
+{
+public:
+	explicit Plain(int speed) : speed(speed) {}
+
+	Unit* clone() const override
+	{
+		return new Plain(*this);
+	}
+	void info() override
+	{
+		std::cout << "Plain, speed " << speed << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int speed;
+};
+
+class Solder : public Unit
+{
+public:
+	explicit Solder(int ammo) : ammo(ammo) {}
+
+	Unit* clone() const override
+	{
+		return new Solder(*this);
+	}
+	void info() override
+	{
+		std::cout << "Solder, ammo " << ammo << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	int ammo;
+};
+
+#pragma endregion
+
+#pragma region Benchmark
+
+// The same registry as a std::map behind a reader-writer lock
+class LockedRegistry
+{
+public:
+	Unit* create(Entity_ID id)
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+		auto found = prototypes.find(id);
+		return found != prototypes.end() ? found->second->clone() : nullptr;
+	}
+	void addPrototype(Entity_ID id, std::shared_ptr<const Unit> prototype)
+	{
+		std::unique_lock<std::shared_mutex> lock(mutex);
+		prototypes[id] = std::move(prototype);
+	}
+
+private:
+	std::shared_mutex mutex;
+	std::map<Entity_ID, std::shared_ptr<const Unit>> prototypes;
+};
+
+// Spawns per second of all readers, while a writer replaces
+// the tank prototype as fast as it can (or not at all)
+template<class Registry>
+double measure(Registry& registry, unsigned readers, bool patching)
+{
+	const auto duration = std::chrono::milliseconds(200);
+	std::atomic<bool> running{ true };
+	std::atomic<long long> spawns{ 0 };
+	std::vector<std::thread> threads;
+
+	for (unsigned r = 0; r < readers; r++)
+	{
+		threads.emplace_back([&registry, &running, &spawns]()
+		{
+			long long count = 0;
+			while (running.load(std::memory_order_relaxed))
+			{
+				delete registry.create(Entity_ID(count % 3));
+				count++;
+			}
+			spawns += count;
+		});
+	}
+	if (patching)
+	{
+		threads.emplace_back([&registry, &running]()
+		{
+			for (int armor = 0; running.load(std::memory_order_relaxed); armor++)
+				registry.addPrototype(Entity_ID::Tank_ID, std::make_shared<Tank>(armor));
+		});
+	}
+
+	std::this_thread::sleep_for(duration);
+	running = false;
+	for (auto& thread : threads)
+		thread.join();
+
+	return spawns / std::chrono::duration<double>(duration).count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	PrototypeRegistry& registry = PrototypeRegistry::getInstance();
+	registry.addPrototype(Entity_ID::Tank_ID, std::make_shared<Tank>(5));
+	registry.addPrototype(Entity_ID::Plain_ID, std::make_shared<Plain>(900));
+	registry.addPrototype(Entity_ID::Solder_ID, std::make_shared<Solder>(30));
+
+	Unit* before = registry.create(Entity_ID::Tank_ID);
+
+	// Balance patch
+	registry.addPrototype(Entity_ID::Tank_ID, std::make_shared<Tank>(7));
+	Unit* after = registry.create(Entity_ID::Tank_ID);
+
+	before->info();
+	after->info();
+	delete before;
+	delete after;
+	// ...
+
+	LockedRegistry locked;
+	locked.addPrototype(Entity_ID::Tank_ID, std::make_shared<Tank>(5));
+	locked.addPrototype(Entity_ID::Plain_ID, std::make_shared<Plain>(900));
+	locked.addPrototype(Entity_ID::Solder_ID, std::make_shared<Solder>(30));
+
+	// main() holds a reader slot too
+	unsigned readers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+	readers = unsigned(std::min<std::size_t>(readers, PrototypeRegistry::maxReaders - 1));
+	std::cout << std::endl << readers << " spawning threads, spawns per second, millions:" << std::endl;
+	std::cout << "\t\tidle writer\tpatching writer" << std::endl;
+	std::cout << "shared_mutex\t" << measure(locked, readers, false) / 1e6
+		<< "\t\t" << measure(locked, readers, true) / 1e6 << std::endl;
+	std::cout << "RCU\t\t" << measure(registry, readers, false) / 1e6
+		<< "\t\t" << measure(registry, readers, true) / 1e6 << std::endl;
+
+	return 0;
+}
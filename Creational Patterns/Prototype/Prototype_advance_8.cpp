@@ -0,0 +1,276 @@
+/*
+ * C++ Design Patterns: Prototype
+ *
+ * Specify the kinds of objects to create using a prototypical instance, and create
+ * new objects by copying this prototype. Pattern has creational purpose and deals
+ * with object relationships, which are more dynamic. The pattern hides the complexities
+ * of making new instances from the client.
+ *
+ * In this variant the registry is built by the compiler. The prototypes are constant
+ * objects and the table of creators is made from a list of unit types, so nothing
+ * runs before main(): no static constructors, no guard of a local static and no map.
+ * The price is that the set of prototypes is fixed at compile time.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<array>
+#include<map>
+#include<chrono>
+#include<cstddef>
+
+/*
+ * ### When to use ###
+ *
+ * when the classes to instantiate are specified at run-time
+ * to avoid building a class hierarchy of factories that parallels the class hierarchy of products
+ * when instances of a class can have one of only a few different combinations of state
+ *
+ */
+
+// Identifiers of all units. Count is not a unit:
+// it is the number of identifiers and must stay last
+enum class Entity_ID
+{
+	Tank_ID = 0,
+	Plain_ID,
+	Solder_ID,
+	Count
+};
+
+// List of types, only used at compile time
+template<class... Types>
+struct TypeList {};
+
+// Polymorphic base class. It also defines static
+// generalized constructor and destructor for units.
+// A prototype must have a trivial destructor to be constant-initialized,
+// so the destructor is not virtual and units are destroyed with Unit::destroy()
+class Unit
+{
+public:
+	virtual Unit* clone() const	= 0;
+	virtual void info() const	= 0;
+
+	static Unit* create(Entity_ID id);
+	static void destroy(Unit* unit)
+	{
+		unit->dispose();
+	}
+	// ...
+
+protected:
+	constexpr Unit()						= default;
+	constexpr Unit(const Unit&)				= default;
+	Unit& operator = (const Unit&)			= default;
+	~Unit()									= default;
+
+	virtual void dispose()					= 0;
+
+	int health = 100;
+};
+
+// Every unit type names its identifier and holds its prototype
+// as a constant, which the compiler places in read-only data
+#pragma region Units
+
+class Tank final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Tank_ID;
+	static const Tank prototype;
+
+	Unit* clone() const override
+	{
+		return new Tank(*this);
+	}
+	void info() const override
+	{
+		std::cout << "Tank" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	constexpr Tank() = default;
+
+	void dispose() override
+	{
+		delete this;
+	}
+
+	int armor = 5;
+};
+
+class Plain final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Plain_ID;
+	static const Plain prototype;
+
+	Unit* clone() const override
+	{
+		return new Plain(*this);
+	}
+	void info() const override
+	{
+		std::cout << "Plain" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	constexpr Plain() = default;
+
+	void dispose() override
+	{
+		delete this;
+	}
+
+	int speed = 900;
+};
+
+class Solder final : public Unit
+{
+public:
+	static constexpr Entity_ID id = Entity_ID::Solder_ID;
+	static const Solder prototype;
+
+	Unit* clone() const override
+	{
+		return new Solder(*this);
+	}
+	void info() const override
+	{
+		std::cout << "Solder" << std::endl;
+		// ...
+	}
+	// ...
+
+private:
+	constexpr Solder() = default;
+
+	void dispose() override
+	{
+		delete this;
+	}
+
+	int ammo = 30;
+};
+
+constexpr Tank		Tank::prototype{};
+constexpr Plain		Plain::prototype{};
+constexpr Solder	Solder::prototype{};
+
+#pragma endregion
+
+// All prototypes. A new unit type is added here and to Entity_ID
+typedef TypeList<Tank, Plain, Solder> Prototypes;
+
+typedef Unit* (*Creator)();
+typedef std::array<Creator, std::size_t(Entity_ID::Count)> CreatorTable;
+
+// The prototype is known statically, so the call of clone() is not virtual
+template<class T>
+Unit* cloneOf()
+{
+	return T::prototype.T::clone();
+}
+
+template<class... Types>
+constexpr CreatorTable makeTable(TypeList<Types...>)
+{
+	CreatorTable table{};
+	((table[std::size_t(Types::id)] = &cloneOf<Types>), ...);
+	return table;
+}
+
+// Every identifier has exactly one prototype
+template<class... Types>
+constexpr bool coversAllIds(TypeList<Types...>)
+{
+	std::size_t count[std::size_t(Entity_ID::Count)] = {};
+	((count[std::size_t(Types::id)]++), ...);
+	for (std::size_t n : count)
+		if (n != 1)
+			return false;
+	return true;
+}
+
+static_assert(coversAllIds(Prototypes{}), "every Entity_ID needs exactly one prototype");
+
+// Constant-initialized: the table is in the executable, not built at startup
+constexpr CreatorTable creators = makeTable(Prototypes{});
+
+Unit* Unit::create(Entity_ID id)
+{
+	std::size_t index = std::size_t(id);
+
+	if (index < creators.size())
+		return creators[index]();
+	return nullptr;
+}
+
+#pragma region Benchmark
+
+// The registry of Prototype_advance_1.cpp: a std::map in a local static,
+// with its guard checked on every call. Filled in main() for the comparison
+std::map<Entity_ID, const Unit*>& getMapRegistry()
+{
+	static std::map<Entity_ID, const Unit*> _instance;
+	return _instance;
+}
+
+Unit* createFromMap(Entity_ID id)
+{
+	std::map<Entity_ID, const Unit*>& reg = getMapRegistry();
+
+	if (reg.find(id) != reg.end())
+		return reg[id]->clone();
+	return nullptr;
+}
+
+// Latency of one create() and destroy() for a mix of all types. The call goes
+// through a volatile pointer, so it is not inlined into the loop
+double measure(Unit* (*function)(Entity_ID))
+{
+	Unit* (*volatile create)(Entity_ID) = function;
+	const int spawns = 3000000;
+	const std::size_t types = std::size_t(Entity_ID::Count);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < spawns; i++)
+		Unit::destroy(create(Entity_ID(i % types)));
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / spawns;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	std::vector<Unit*> vec;
+	vec.push_back(Unit::create(Entity_ID::Tank_ID));
+	vec.push_back(Unit::create(Entity_ID::Plain_ID));
+	vec.push_back(Unit::create(Entity_ID::Solder_ID));
+
+	for (auto& object : vec)
+		object->info();
+	// ...
+
+	for (auto& object : vec)
+		Unit::destroy(object);
+
+	getMapRegistry()[Entity_ID::Tank_ID] = &Tank::prototype;
+	getMapRegistry()[Entity_ID::Plain_ID] = &Plain::prototype;
+	getMapRegistry()[Entity_ID::Solder_ID] = &Solder::prototype;
+
+	std::cout << std::endl << "create() + destroy(), ns:" << std::endl;
+	std::cout << "std::map:       " << measure(createFromMap) << std::endl;
+	std::cout << "constant table: " << measure(Unit::create) << std::endl;
+
+	return 0;
+}
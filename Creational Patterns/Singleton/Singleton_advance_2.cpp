@@ -0,0 +1,173 @@
+/*
+ * C++ Design Patterns: Singleton
+ *
+ * Ensure a class only has one instance, and provide a global point of access to it.
+ * Pattern has creational purpose and deals with object relationships, which are more
+ * dynamic. The Singleton is often used as a part another design patterns (see [Facade]
+ * and [Flyweight]).
+ *
+ * This variant is safe to use from many threads. The instance is a local static
+ * variable: since C++11 the compiler guarantees that it is constructed exactly once,
+ * and after that every access is a check of an already set guard, without locks.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<thread>
+#include<mutex>
+#include<atomic>
+#include<chrono>
+#include<algorithm>
+
+/*
+ * ### When to use ###
+ *
+ * there must be exactly one instance of a class, and it must be accessible to clients from a well-known access point
+ * when the sole instance is accessed from many threads, and lazy initialization must not create it twice
+ *
+ */
+
+class Singleton
+{
+public:
+	static Singleton& getInstance();
+	void about();
+	int value() const;
+	// ...
+
+protected:
+	Singleton();
+	~Singleton()						= default;
+	Singleton(const Singleton&)			= delete;
+	Singleton& operator = (Singleton&)	= delete;
+
+private:
+	int data;
+	// ...
+};
+
+// Other ways to write getInstance(), for comparison
+#pragma region Benchmark
+
+// As in Singleton_advance.cpp: two threads may both see nullptr and create two instances
+class RacySingleton
+{
+public:
+	static RacySingleton& getInstance()
+	{
+		if (instance == nullptr)
+			instance = new RacySingleton();
+		return *instance;
+	}
+	int value() const { return data; }
+
+private:
+	static RacySingleton* instance;
+	int data = 42;
+};
+
+RacySingleton* RacySingleton::instance = nullptr;
+
+// Correct, but every access takes the same lock
+class LockedSingleton
+{
+public:
+	static LockedSingleton& getInstance()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (instance == nullptr)
+			instance = new LockedSingleton();
+		return *instance;
+	}
+	int value() const { return data; }
+
+private:
+	static std::mutex mutex;
+	static LockedSingleton* instance;
+	int data = 42;
+};
+
+std::mutex LockedSingleton::mutex;
+LockedSingleton* LockedSingleton::instance = nullptr;
+
+// Keeps the measured loops from being optimized away
+std::atomic<long long> sink{ 0 };
+
+// Calls per second of getInstance() summed over all threads. The access goes
+// through a volatile function pointer, so the compiler cannot hoist it out of the loop
+double measure(unsigned threads, int (*access)())
+{
+	const int calls = 2000000;
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.emplace_back([access]()
+		{
+			int (*volatile call)() = access;
+			long long sum = 0;
+			for (int i = 0; i < calls; i++)
+				sum += call();
+			sink += sum;
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return double(threads) * calls / elapsed.count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	Singleton::getInstance().about();
+
+	// The racy version is created up front, so that the measurement
+	// only covers the access path and not the race itself
+	RacySingleton::getInstance();
+
+	std::cout << std::endl << "getInstance() calls per second, millions:" << std::endl;
+	std::cout << "threads\tracy\tmutex\tlocal static" << std::endl;
+
+	unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= hardware; threads *= 2)
+	{
+		std::cout << threads
+			<< "\t" << measure(threads, []() { return RacySingleton::getInstance().value(); }) / 1e6
+			<< "\t" << measure(threads, []() { return LockedSingleton::getInstance().value(); }) / 1e6
+			<< "\t" << measure(threads, []() { return Singleton::getInstance().value(); }) / 1e6 << std::endl;
+	}
+
+	return 0;
+}
+
+Singleton::Singleton() : data(42)
+{
+	std::cout << "Singleton is constructed" << std::endl;
+	// ...
+}
+
+Singleton& Singleton::getInstance()
+{
+	// Constructed on first use; concurrent first calls wait for the one that
+	// constructs it. Afterwards the guard check is a plain load on x86 and a
+	// load-acquire on ARM, and the instance is destroyed at program exit
+	static Singleton instance;
+	return instance;
+}
+
+void Singleton::about()
+{
+	std::cout << "This is Singleton." << std::endl;
+	// ...
+}
+
+int Singleton::value() const
+{
+	return this->data;
+}
@@ -0,0 +1,156 @@
+/*
+ * C++ Design Patterns: Singleton
+ *
+ * Ensure a class only has one instance, and provide a global point of access to it.
+ * Pattern has creational purpose and deals with object relationships, which are more
+ * dynamic. The Singleton is often used as a part another design patterns (see [Facade]
+ * and [Flyweight]).
+ *
+ * This variant is for state which can be computed at compile time, such as
+ * configuration and lookup tables. The constructor is constexpr, so the instance
+ * is constant-initialized in static storage: there is no heap allocation, no guard
+ * variable and no Destroyer, and getInstance() is just the address of the instance.
+ *
+ */
+
+#include<iostream>
+#include<chrono>
+
+/*
+ * ### When to use ###
+ *
+ * there must be exactly one instance of a class, and it must be accessible to clients from a well-known access point
+ * when the state of the instance is known at compile time and never needs to be created lazily
+ *
+ */
+
+class Singleton
+{
+public:
+	static const int tableSize = 256;
+
+	static const Singleton& getInstance();
+	void about() const;
+	int lookup(int index) const;
+	// ...
+
+private:
+	// Builds the table of squares at compile time
+	constexpr Singleton() : table()
+	{
+		for (int i = 0; i < tableSize; i++)
+			table[i] = i * i;
+	}
+	~Singleton()						= default;
+	Singleton(const Singleton&)			= delete;
+	Singleton& operator = (Singleton&)	= delete;
+
+	static const Singleton instance;
+	int table[tableSize];
+	// ...
+};
+
+// The definition is a constant expression, so the object is laid out by the
+// compiler in the data segment and exists before any code runs
+constexpr Singleton Singleton::instance{};
+
+// Other ways to write getInstance(), for comparison
+#pragma region Benchmark
+
+// As in Singleton_advance.cpp: allocated on first access
+class HeapSingleton
+{
+public:
+	static HeapSingleton& getInstance()
+	{
+		if (instance == nullptr)
+			instance = new HeapSingleton();
+		return *instance;
+	}
+	int lookup(int index) const { return table[index]; }
+
+private:
+	HeapSingleton()
+	{
+		for (int i = 0; i < Singleton::tableSize; i++)
+			table[i] = i * i;
+	}
+
+	static HeapSingleton* instance;
+	int table[Singleton::tableSize];
+};
+
+HeapSingleton* HeapSingleton::instance = nullptr;
+
+// Function-local static: checks a guard variable on every access
+class GuardedSingleton
+{
+public:
+	static GuardedSingleton& getInstance()
+	{
+		static GuardedSingleton instance;
+		return instance;
+	}
+	int lookup(int index) const { return table[index]; }
+
+private:
+	GuardedSingleton()
+	{
+		for (int i = 0; i < Singleton::tableSize; i++)
+			table[i] = i * i;
+	}
+
+	int table[Singleton::tableSize];
+};
+
+// Keeps the measured loops from being optimized away
+volatile long long sink = 0;
+
+// The accessor is called through a volatile function pointer,
+// so the compiler cannot hoist the access out of the loop
+double measure(int (*access)(int))
+{
+	const int calls = 20000000;
+	int (*volatile call)(int) = access;
+
+	auto start = std::chrono::steady_clock::now();
+	long long sum = 0;
+	for (int i = 0; i < calls; i++)
+		sum += call(i & (Singleton::tableSize - 1));
+	sink = sum;
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+	return elapsed.count() / calls;
+}
+
+#pragma endregion
+
+
+int main()
+{
+	Singleton::getInstance().about();
+	std::cout << "12 squared is " << Singleton::getInstance().lookup(12) << std::endl;
+
+	std::cout << std::endl << "Nanoseconds per accessor call:" << std::endl;
+	std::cout << "heap + null check:   " << measure([](int i) { return HeapSingleton::getInstance().lookup(i); }) << std::endl;
+	std::cout << "local static guard:  " << measure([](int i) { return GuardedSingleton::getInstance().lookup(i); }) << std::endl;
+	std::cout << "constant-initialized: " << measure([](int i) { return Singleton::getInstance().lookup(i); }) << std::endl;
+
+	return 0;
+}
+
+const Singleton& Singleton::getInstance()
+{
+	return instance;
+}
+
+void Singleton::about() const
+{
+	std::cout << "This is Singleton." << std::endl;
+	// ...
+}
+
+int Singleton::lookup(int index) const
+{
+	return this->table[index];
+}
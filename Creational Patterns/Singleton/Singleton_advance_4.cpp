@@ -0,0 +1,311 @@
+/*
+ * C++ Design Patterns: Singleton
+ *
+ * Ensure a class only has one instance, and provide a global point of access to it.
+ * Pattern has creational purpose and deals with object relationships, which are more
+ * dynamic. The Singleton is often used as a part another design patterns (see [Facade]
+ * and [Flyweight]).
+ *
+ * This variant manages many singletons at once. Every singleton declares the ones it
+ * depends on; at startup the registry builds them in dependency order, constructing
+ * independent singletons in parallel, and at shutdown destroys them in reverse order.
+ * The time spent in every constructor is reported.
+ *
+ */
+
+#include<iostream>
+#include<iomanip>
+#include<string>
+#include<vector>
+#include<map>
+#include<deque>
+#include<functional>
+#include<mutex>
+#include<condition_variable>
+#include<thread>
+#include<chrono>
+#include<algorithm>
+#include<stdexcept>
+#include<exception>
+
+/*
+ * ### When to use ###
+ *
+ * there must be exactly one instance of a class, and it must be accessible to clients from a well-known access point
+ * when a program has many singletons which depend on each other and are slow to create
+ *
+ */
+
+class SingletonRegistry
+{
+public:
+	static SingletonRegistry& getInstance()
+	{
+		static SingletonRegistry instance;
+		return instance;
+	}
+
+	// Records how to build T; nothing is constructed until startup()
+	template<class T>
+	void add(const std::string& name, const std::vector<std::string>& dependencies)
+	{
+		Entry entry;
+		entry.name = name;
+		entry.dependencies = dependencies;
+		entry.create = []() { slot<T>() = new T(); };
+		entry.destroy = []() { delete slot<T>(); slot<T>() = nullptr; };
+		entries.push_back(entry);
+	}
+	// Access to a built singleton
+	template<class T>
+	static T& get()
+	{
+		return *slot<T>();
+	}
+
+	void startup(unsigned threads);
+	void shutdown();
+	void report();
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::vector<std::string> dependencies;
+		std::function<void()> create;
+		std::function<void()> destroy;
+
+		std::vector<std::size_t> dependents;
+		std::size_t waitingFor = 0;
+		double milliseconds = 0.0;
+	};
+
+	template<class T>
+	static T*& slot()
+	{
+		static T* instance = nullptr;
+		return instance;
+	}
+
+	SingletonRegistry()										= default;
+	~SingletonRegistry()									= default;
+	SingletonRegistry(const SingletonRegistry&)				= delete;
+	SingletonRegistry& operator = (SingletonRegistry&)		= delete;
+
+	std::vector<Entry> entries;
+	std::vector<std::size_t> built;		// indices in the order construction finished
+	double wallMilliseconds = 0.0;
+};
+
+// Registers a singleton from a static object, next to the class it describes
+template<class T>
+class Registrar
+{
+public:
+	Registrar(const std::string& name, const std::vector<std::string>& dependencies = {})
+	{
+		SingletonRegistry::getInstance().add<T>(name, dependencies);
+	}
+};
+
+// Simulated services, each slow to construct
+#pragma region Services
+
+void work(int milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+class Config
+{
+public:
+	Config()		{ work(20); }
+	~Config()		{ std::cout << "Config is destruct" << std::endl; }
+	int cacheSize()	{ return 1024; }
+};
+
+class Logger
+{
+public:
+	Logger()		{ work(20); }
+	~Logger()		{ std::cout << "Logger is destruct" << std::endl; }
+};
+
+class Cache
+{
+public:
+	// Dependencies are already built when the constructor runs
+	Cache() : size(SingletonRegistry::get<Config>().cacheSize()) { work(60); }
+	~Cache()		{ std::cout << "Cache is destruct" << std::endl; }
+
+	int size;
+};
+
+class ConnectionPool
+{
+public:
+	ConnectionPool()	{ work(60); }
+	~ConnectionPool()	{ std::cout << "ConnectionPool is destruct" << std::endl; }
+};
+
+class SearchIndex
+{
+public:
+	SearchIndex()	{ work(40); }
+	~SearchIndex()	{ std::cout << "SearchIndex is destruct" << std::endl; }
+};
+
+class Service
+{
+public:
+	Service()		{ work(10); }
+	~Service()		{ std::cout << "Service is destruct" << std::endl; }
+	void about()	{ std::cout << "This is Service." << std::endl; }
+};
+
+static Registrar<Config>			configRegistrar("Config");
+static Registrar<Logger>			loggerRegistrar("Logger", { "Config" });
+static Registrar<Cache>				cacheRegistrar("Cache", { "Config" });
+static Registrar<ConnectionPool>	poolRegistrar("ConnectionPool", { "Config" });
+static Registrar<SearchIndex>		indexRegistrar("SearchIndex", { "Cache", "ConnectionPool" });
+static Registrar<Service>			serviceRegistrar("Service", { "Logger", "SearchIndex" });
+
+#pragma endregion
+
+
+int main()
+{
+	SingletonRegistry& registry = SingletonRegistry::getInstance();
+
+	registry.startup(4);
+	registry.report();
+
+	std::cout << std::endl;
+	SingletonRegistry::get<Service>().about();
+	std::cout << "cache size: " << SingletonRegistry::get<Cache>().size << std::endl;
+	std::cout << std::endl;
+
+	registry.shutdown();
+
+	return 0;
+}
+
+// Builds all singletons on a pool of threads, in topological order of their dependencies.
+// If a constructor throws, nothing more is scheduled, the singletons already built
+// are destroyed and the exception is rethrown here
+void SingletonRegistry::startup(unsigned threads)
+{
+	std::map<std::string, std::size_t> byName;
+	for (std::size_t i = 0; i < entries.size(); i++)
+		byName[entries[i].name] = i;
+
+	std::deque<std::size_t> ready;
+	for (std::size_t i = 0; i < entries.size(); i++)
+	{
+		for (auto& dependency : entries[i].dependencies)
+		{
+			auto found = byName.find(dependency);
+			if (found == byName.end())
+				throw std::logic_error(entries[i].name + " depends on unknown " + dependency);
+			entries[found->second].dependents.push_back(i);
+		}
+		entries[i].waitingFor = entries[i].dependencies.size();
+		if (entries[i].waitingFor == 0)
+			ready.push_back(i);
+	}
+
+	std::mutex mutex;
+	std::condition_variable changed;
+	std::size_t running = 0;
+	std::exception_ptr failure;
+
+	auto worker = [&]()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			changed.wait(lock, [&]() { return !ready.empty() || running == 0 || failure; });
+			if (ready.empty() || failure)
+				return;
+
+			std::size_t index = ready.front();
+			ready.pop_front();
+			running++;
+
+			lock.unlock();
+			auto start = std::chrono::steady_clock::now();
+			std::exception_ptr error;
+			try
+			{
+				entries[index].create();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			lock.lock();
+
+			running--;
+			if (error)
+			{
+				if (!failure)
+					failure = error;
+				ready.clear();
+				changed.notify_all();
+				continue;
+			}
+
+			entries[index].milliseconds = elapsed.count();
+			built.push_back(index);
+
+			for (auto dependent : entries[index].dependents)
+				if (--entries[dependent].waitingFor == 0)
+					ready.push_back(dependent);
+
+			changed.notify_all();
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> pool;
+	for (unsigned t = 0; t < std::max(1u, threads); t++)
+		pool.emplace_back(worker);
+	for (auto& thread : pool)
+		thread.join();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	wallMilliseconds = elapsed.count();
+
+	if (failure)
+	{
+		shutdown();
+		std::rethrow_exception(failure);
+	}
+	if (built.size() != entries.size())
+	{
+		shutdown();
+		throw std::logic_error("singleton dependencies contain a cycle");
+	}
+}
+
+// Destroys singletons in reverse order, so that every one of them
+// outlives the singletons which depend on it
+void SingletonRegistry::shutdown()
+{
+	for (auto i = built.rbegin(); i != built.rend(); ++i)
+		entries[*i].destroy();
+	built.clear();
+}
+
+void SingletonRegistry::report()
+{
+	double serial = 0.0;
+	std::cout << "Singleton initialization, ms:" << std::endl;
+	for (auto index : built)
+	{
+		std::cout << "  " << std::left << std::setw(16) << entries[index].name
+			<< std::fixed << std::setprecision(1) << entries[index].milliseconds << std::endl;
+		serial += entries[index].milliseconds;
+	}
+	std::cout << "total " << serial << " ms of work, done in " << wallMilliseconds << " ms" << std::endl;
+}
@@ -0,0 +1,208 @@
+/*
+ * C++ Design Patterns: Singleton
+ *
+ * Ensure a class only has one instance, and provide a global point of access to it.
+ * Pattern has creational purpose and deals with object relationships, which are more
+ * dynamic. The Singleton is often used as a part another design patterns (see [Facade]
+ * and [Flyweight]).
+ *
+ * This variant gives one instance to every thread. Each thread builds its own
+ * instance on first access and updates it without locks; the instances are kept in
+ * a list, so a merge function can combine them into one total whenever it is needed.
+ * When a thread exits, its instance is merged into the total of finished threads.
+ *
+ */
+
+#include<iostream>
+#include<vector>
+#include<list>
+#include<functional>
+#include<mutex>
+#include<atomic>
+#include<thread>
+#include<chrono>
+#include<algorithm>
+#include<stdexcept>
+
+/*
+ * ### When to use ###
+ *
+ * there must be exactly one instance of a class, and it must be accessible to clients from a well-known access point
+ * when the state is updated very often from many threads, and only its combined value is read, and rarely
+ *
+ */
+
+template<class T>
+class ThreadSingleton
+{
+public:
+	typedef std::function<void(T& total, const T& part)> Merge;
+
+	// The instance of the calling thread, built on its first call.
+	// The merge must be set before, or the state of the thread could be lost
+	static T& getInstance()
+	{
+		thread_local Holder holder;
+		return holder.instance;
+	}
+	static void setMerge(Merge merge)
+	{
+		if (!merge)
+			throw std::invalid_argument("ThreadSingleton: empty merge");
+
+		State& s = state();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		s.merge = merge;
+	}
+	// Combines the instances of all threads, running and finished.
+	// Threads keep updating their instances meanwhile, so T must allow
+	// its fields to be read concurrently (for example, relaxed atomics)
+	static T total()
+	{
+		State& s = state();
+		std::lock_guard<std::mutex> lock(s.mutex);
+
+		T result;
+		if (s.merge)
+		{
+			s.merge(result, s.finished);
+			for (auto instance : s.live)
+				s.merge(result, *instance);
+		}
+		// Without a merge no thread has an instance yet
+		return result;
+	}
+
+private:
+	struct State
+	{
+		std::mutex mutex;
+		std::list<T*> live;
+		T finished;
+		Merge merge;
+	};
+
+	// Lives in thread-local storage and registers its instance for the lifetime of the thread
+	struct Holder
+	{
+		Holder()
+		{
+			State& s = state();
+			std::lock_guard<std::mutex> lock(s.mutex);
+			if (!s.merge)
+				throw std::logic_error("ThreadSingleton: getInstance() before setMerge()");
+			s.live.push_back(&instance);
+		}
+		~Holder()
+		{
+			State& s = state();
+			std::lock_guard<std::mutex> lock(s.mutex);
+			s.merge(s.finished, instance);
+			s.live.remove(&instance);
+		}
+
+		T instance;
+	};
+
+	static State& state()
+	{
+		static State instance;
+		return instance;
+	}
+};
+
+// Hot mutable state: counters updated by every thread
+class Statistics
+{
+public:
+	Statistics() = default;
+	Statistics(const Statistics& other) : requests(other.value()) {}
+
+	// Only the owning thread writes, so a relaxed load and store replace
+	// a locked read-modify-write; total() may read the value at any time
+	void count()
+	{
+		requests.store(requests.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+	long long value() const
+	{
+		return requests.load(std::memory_order_relaxed);
+	}
+	void add(const Statistics& other)
+	{
+		requests.store(value() + other.value(), std::memory_order_relaxed);
+	}
+	// ...
+
+private:
+	std::atomic<long long> requests{ 0 };
+};
+
+#pragma region Benchmark
+
+// The same counter as one shared instance
+std::atomic<long long> sharedCounter{ 0 };
+std::mutex counterMutex;
+long long lockedCounter = 0;
+
+// Updates per second summed over all threads
+template<class Update>
+double measure(unsigned threads, Update update)
+{
+	const int updates = 2000000;
+	std::vector<std::thread> workers;
+
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned t = 0; t < threads; t++)
+	{
+		workers.emplace_back([update]()
+		{
+			for (int i = 0; i < updates; i++)
+				update();
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	return double(threads) * updates / elapsed.count();
+}
+
+#pragma endregion
+
+
+int main()
+{
+	ThreadSingleton<Statistics>::setMerge([](Statistics& total, const Statistics& part) { total.add(part); });
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < 4; t++)
+	{
+		workers.emplace_back([t]()
+		{
+			for (int i = 0; i < 1000 * (t + 1); i++)
+				ThreadSingleton<Statistics>::getInstance().count();
+		});
+	}
+	for (int i = 0; i < 500; i++)
+		ThreadSingleton<Statistics>::getInstance().count();
+	for (auto& worker : workers)
+		worker.join();
+
+	std::cout << "requests counted by all threads: " << ThreadSingleton<Statistics>::total().value() << std::endl;
+	// ...
+
+	std::cout << std::endl << "Counter updates per second, millions:" << std::endl;
+	std::cout << "threads\tmutex\tshared atomic\tper thread" << std::endl;
+
+	unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= hardware; threads *= 2)
+	{
+		std::cout << threads
+			<< "\t" << measure(threads, []() { std::lock_guard<std::mutex> lock(counterMutex); lockedCounter++; }) / 1e6
+			<< "\t" << measure(threads, []() { sharedCounter.fetch_add(1, std::memory_order_relaxed); }) / 1e6
+			<< "\t\t" << measure(threads, []() { ThreadSingleton<Statistics>::getInstance().count(); }) / 1e6 << std::endl;
+	}
+
+	return 0;
+}